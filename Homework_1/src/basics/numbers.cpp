@@ -1,122 +1,958 @@
 #include "numbers.h"
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
 #include <limits>
-#include <map>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 namespace mse {
+namespace {
+// Digit sums of 0..9999: a 32-bit magnitude takes three lookups.
+constexpr std::array<std::uint8_t, 10000> digit_sums = [] {
+  std::array<std::uint8_t, 10000> table{};
+  for (std::size_t i = 1; i < table.size(); i++)
+    table[i] = static_cast<std::uint8_t>(table[i / 10] + i % 10);
+  return table;
+}();
+
+std::uint32_t magnitude(std::int32_t x) {
+  return x < 0 ? 0u - static_cast<std::uint32_t>(x)
+               : static_cast<std::uint32_t>(x);
+}
+
+// Values processed together by sum_digits_batch. Table lookups would become
+// gathers, so the batch kernel splits every magnitude into three base-10^4
+// parts and sums their digits arithmetically in 16-bit lanes, where division
+// by a constant is a native SIMD multiply-high.
+constexpr std::size_t digit_lanes = 16;
+
+void sum_digits_block(const std::int32_t *numbers, std::size_t *out) {
+  // Separate simple loops over lanes, each of which the compiler vectorizes.
+  std::uint32_t rest[digit_lanes];
+  std::uint32_t high[digit_lanes];
+  std::uint32_t top[digit_lanes];
+  for (std::size_t l = 0; l < digit_lanes; l++)
+    rest[l] = magnitude(numbers[l]);
+  for (std::size_t l = 0; l < digit_lanes; l++)
+    high[l] = rest[l] / 10000;
+  for (std::size_t l = 0; l < digit_lanes; l++)
+    top[l] = high[l] / 10000;
+
+  std::uint16_t part[3][digit_lanes];
+  for (std::size_t l = 0; l < digit_lanes; l++) {
+    part[0][l] = static_cast<std::uint16_t>(rest[l] - high[l] * 10000);
+    part[1][l] = static_cast<std::uint16_t>(high[l] - top[l] * 10000);
+    part[2][l] = static_cast<std::uint16_t>(top[l]);
+  }
+
+  // For x = sum of d_i * 10^i, floor(x / 10^k) summed over k >= 1 equals
+  // sum of d_i * (10^i - 1) / 9, so the digit sum of a part below 10^4 is
+  // x - 9 * (x / 10 + x / 100 + x / 1000): three independent divisions.
+  std::uint16_t sum[digit_lanes] = {};
+  for (const auto &digits : part) {
+    for (std::size_t l = 0; l < digit_lanes; l++) {
+      const std::uint16_t x = digits[l];
+      const auto shifted =
+          static_cast<std::uint16_t>(x / 10 + x / 100 + x / 1000);
+      sum[l] = static_cast<std::uint16_t>(sum[l] + x - 9 * shifted);
+    }
+  }
+
+  for (std::size_t l = 0; l < digit_lanes; l++)
+    out[l] = sum[l];
+}
+} // namespace
+
 std::size_t sum_digits(std::int32_t number){
-  std::string s = std::to_string(number);
+  const std::uint32_t rest = magnitude(number);
+  return digit_sums[rest % 10000] + digit_sums[rest / 10000 % 10000] +
+         digit_sums[rest / 100000000];
+}
+
+void sum_digits_batch(std::span<const std::int32_t> numbers,
+                      std::span<std::size_t> out) {
+  if (numbers.size() != out.size())
+    throw std::invalid_argument(
+        "sum_digits_batch: spans must have equal sizes.");
 
-  int sum = 0;
+  std::size_t i = 0;
+  for (; i + digit_lanes <= numbers.size(); i += digit_lanes)
+    sum_digits_block(numbers.data() + i, out.data() + i);
+  for (; i < numbers.size(); i++)
+    out[i] = sum_digits(numbers[i]);
+}
+
+namespace {
+constexpr std::uint32_t trial_primes[] = {2,  3,  5,  7,  11, 13, 17, 19,
+                                          23, 29, 31, 37, 41, 43, 47, 53};
 
-  for (auto & c : s) {
-    if (c != '-')
-      sum += (c - '0');
+// Arithmetic modulo an odd n in Montgomery form x * 2^64 mod n, where a
+// product costs two widening multiplies and no division.
+class montgomery {
+public:
+  explicit montgomery(std::uint64_t n) : n_(n), inverse_(n) {
+    // Newton's iteration doubles the number of correct low bits of n^-1;
+    // n itself is already correct to 3 bits.
+    for (int i = 0; i < 5; i++)
+      inverse_ *= 2 - n * inverse_;
+    one_ = (0 - n) % n;
+    r2_ = static_cast<std::uint64_t>((unsigned __int128)one_ * one_ % n);
   }
-  return sum;
+
+  [[nodiscard]] std::uint64_t to_form(std::uint64_t x) const {
+    return multiply(x % n_, r2_);
+  }
+
+  [[nodiscard]] std::uint64_t one() const { return one_; }
+  [[nodiscard]] std::uint64_t minus_one() const { return n_ - one_; }
+
+  [[nodiscard]] std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const {
+    const unsigned __int128 product = (unsigned __int128)a * b;
+    const std::uint64_t m = static_cast<std::uint64_t>(product) * inverse_;
+    const auto high = static_cast<std::uint64_t>(product >> 64);
+    const auto correction =
+        static_cast<std::uint64_t>(((unsigned __int128)m * n_) >> 64);
+    return high >= correction ? high - correction : high - correction + n_;
+  }
+
+  [[nodiscard]] std::uint64_t power(std::uint64_t base,
+                                    std::uint64_t exponent) const {
+    std::uint64_t result = one_;
+    for (; exponent != 0; exponent >>= 1) {
+      if (exponent & 1)
+        result = multiply(result, base);
+      base = multiply(base, base);
+    }
+    return result;
+  }
+
+private:
+  std::uint64_t n_;
+  std::uint64_t inverse_;
+  std::uint64_t one_; // 2^64 mod n
+  std::uint64_t r2_;  // 2^128 mod n
+};
+
+// Strong probable-prime test of an odd n > 2 to base a.
+bool strong_probable_prime(const montgomery &field, std::uint64_t n,
+                           std::uint64_t a) {
+  std::uint64_t d = n - 1;
+  const int s = std::countr_zero(d);
+  d >>= s;
+
+  const std::uint64_t base = field.to_form(a);
+  if (base == 0)
+    return true; // a is a multiple of n and proves nothing
+
+  std::uint64_t x = field.power(base, d);
+  if (x == field.one() || x == field.minus_one())
+    return true;
+  for (int i = 1; i < s; i++) {
+    x = field.multiply(x, x);
+    if (x == field.minus_one())
+      return true;
+  }
+  return false;
 }
+} // namespace
 
-bool is_prime(uint32_t n) {
-  for (uint32_t i = 2; i < n; i++) {
-    if (n % i == 0) {
-      return false;
+bool is_prime(std::uint64_t n) {
+  for (auto p : trial_primes) {
+    if (n % p == 0)
+      return n == p;
+  }
+  if (n < 2)
+    return false;
+  if (n < 59 * 59)
+    return true;
+
+  // Bases that leave no strong pseudoprimes below the respective bound:
+  // {2, 7, 61} up to 2^32 (Jaeschke) and Jim Sinclair's seven bases for
+  // all 64-bit numbers.
+  static constexpr std::uint64_t bases32[] = {2, 7, 61};
+  static constexpr std::uint64_t bases64[] = {
+      2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+  const montgomery field(n);
+  if (n < (std::uint64_t(1) << 32)) {
+    for (auto a : bases32) {
+      if (!strong_probable_prime(field, n, a))
+        return false;
     }
+    return true;
+  }
+  for (auto a : bases64) {
+    if (!strong_probable_prime(field, n, a))
+      return false;
   }
   return true;
 }
 
-std::vector<uint32_t> primes = {2, 3};
-std::size_t count_primes(std::uint32_t limit){
-  auto a = primes;
-  if (limit <= primes[primes.size() - 1]){
-    int32_t l = -1;
-    int32_t r = primes.size();
-
-    while (r - l > 1){
-      int32_t m = (r + l) / 2;
-      if (primes[m] >= limit)
-        r = m;
+namespace {
+// Odd primes p with p * p < limit.
+std::vector<std::uint32_t> sieving_primes(std::uint64_t limit) {
+  std::uint32_t bound = 1;
+  while (std::uint64_t(bound + 1) * (bound + 1) < limit)
+    bound++;
+
+  std::vector<bool> composite(bound + 1, false);
+  std::vector<std::uint32_t> result;
+  for (std::uint32_t i = 3; i <= bound; i += 2) {
+    if (composite[i])
+      continue;
+    result.push_back(i);
+    for (std::uint64_t j = std::uint64_t(i) * i; j <= bound; j += 2 * i)
+      composite[j] = true;
+  }
+  return result;
+}
+
+std::size_t count_bits(const std::uint64_t *words, std::uint64_t bits) {
+  std::size_t count = 0;
+  for (std::uint64_t w = 0; w < bits / 64; w++)
+    count += std::popcount(words[w]);
+  if (bits % 64 != 0)
+    count += std::popcount(words[bits / 64] &
+                           ((std::uint64_t(1) << (bits % 64)) - 1));
+  return count;
+}
+
+// The sieve works on a mod-30 wheel: byte i stands for the eight numbers
+// 30 * i + r with r coprime to 30, so multiples of 2, 3 and 5 take no space
+// and are never crossed off. That is 8 / 15 of the bits and of the crossings
+// of an odd-only layout.
+constexpr std::uint32_t wheel_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+// Bit of 30 * i + r in byte i, for every r coprime to 30.
+constexpr std::array<std::uint8_t, 30> wheel_bit = [] {
+  std::array<std::uint8_t, 30> bits{};
+  for (std::uint8_t k = 0; k < 8; k++)
+    bits[wheel_residues[k]] = k;
+  return bits;
+}();
+
+// Number of residues coprime to 30 that are at most r, i.e. the bits of
+// byte i that stand for numbers up to 30 * i + r.
+constexpr std::array<std::uint8_t, 30> wheel_rank = [] {
+  std::array<std::uint8_t, 30> ranks{};
+  std::uint8_t rank = 0;
+  for (std::uint32_t r = 0; r < 30; r++) {
+    if (std::find(std::begin(wheel_residues), std::end(wheel_residues), r) !=
+        std::end(wheel_residues))
+      rank++;
+    ranks[r] = rank;
+  }
+  return ranks;
+}();
+
+// One wheel segment holds 2^15 bytes, 983040 numbers, and fits in L1.
+constexpr std::uint64_t wheel_segment_bytes = std::uint64_t(1) << 15;
+
+// Multiples of 7, 11, 13 and 17 repeat with period 17017 bytes.
+constexpr std::uint32_t wheel_presieve_primes[] = {7, 11, 13, 17};
+constexpr std::uint64_t wheel_presieve_bytes = 7 * 11 * 13 * 17;
+
+const std::vector<std::uint8_t> &wheel_presieve_pattern() {
+  static const std::vector<std::uint8_t> pattern = [] {
+    std::vector<std::uint8_t> bytes(wheel_presieve_bytes, 0xff);
+    for (auto p : wheel_presieve_primes) {
+      for (std::uint64_t n = p; n < wheel_presieve_bytes * 30; n += 2 * p) {
+        if (n % 3 != 0 && n % 5 != 0)
+          bytes[n / 30] &= static_cast<std::uint8_t>(~(1u << wheel_bit[n % 30]));
+      }
+    }
+    return bytes;
+  }();
+  return pattern;
+}
+
+// The multiples of p coprime to 30 are p * (30 * c + wheel_residues[k]);
+// the k-th of a cycle c lies in byte p * c + offset[k], at the same bit for
+// every c. So, as in cross_off, a whole cycle is eight stores at fixed
+// offsets from a base that advances by p bytes.
+class wheel_prime {
+public:
+  // Crossing off starts at p * multiplier, for a multiplier coprime to 30.
+  wheel_prime(std::uint32_t p, std::uint32_t multiplier)
+      : p_(p), cycle_(multiplier / 30), index_(wheel_bit[multiplier % 30]) {
+    for (std::uint32_t k = 0; k < 8; k++) {
+      offset_[k] = p * wheel_residues[k] / 30;
+      mask_[k] = static_cast<std::uint8_t>(
+          ~(1u << wheel_bit[p * wheel_residues[k] % 30]));
+    }
+  }
+
+  // Crosses off the multiples in bytes [low, low + size) that are not
+  // crossed off yet.
+  void cross_off(std::uint8_t *bytes, std::uint64_t low, std::uint64_t size) {
+    // Stores through bytes may alias any member, so the loops work on
+    // copies. Indices are taken modulo 2^64: p * c - low may wrap, the sum
+    // with an offset does not.
+    const std::uint64_t p = p_;
+    const std::uint64_t end = low + size;
+    std::uint32_t offset[8];
+    std::uint8_t mask[8];
+    std::copy_n(offset_, 8, offset);
+    std::copy_n(mask_, 8, mask);
+    std::uint64_t cycle = cycle_;
+    std::uint32_t index = index_;
+
+    for (; index < 8; index++) {
+      const std::uint64_t at = p * cycle + offset[index];
+      if (at >= end)
+        break;
+      bytes[at - low] &= mask[index];
+    }
+
+    if (index == 8) {
+      cycle++;
+      index = 0;
+      for (; p * cycle + offset[7] < end; cycle++) {
+        const std::uint64_t base = p * cycle - low;
+        bytes[base + offset[0]] &= mask[0];
+        bytes[base + offset[1]] &= mask[1];
+        bytes[base + offset[2]] &= mask[2];
+        bytes[base + offset[3]] &= mask[3];
+        bytes[base + offset[4]] &= mask[4];
+        bytes[base + offset[5]] &= mask[5];
+        bytes[base + offset[6]] &= mask[6];
+        bytes[base + offset[7]] &= mask[7];
+      }
+      for (; p * cycle + offset[index] < end; index++)
+        bytes[p * cycle + offset[index] - low] &= mask[index];
+    }
+
+    cycle_ = cycle;
+    index_ = index;
+  }
+
+private:
+  std::uint32_t p_;
+  std::uint32_t offset_[8];
+  std::uint8_t mask_[8];
+  std::uint64_t cycle_;
+  std::uint32_t index_;
+};
+
+// Primes below this bound hit a segment so often that crossing off their
+// multiples one by one costs more than ANDing the whole segment with a
+// pattern of them, which repeats every p words.
+constexpr std::uint32_t pattern_prime_bound = 128;
+
+// Sieves the wheel bytes of the numbers below a limit above 7, segment by
+// segment in increasing order. Segments start at multiples of 8 bytes.
+class wheel_sieve {
+public:
+  explicit wheel_sieve(std::uint64_t limit)
+      : limit_(limit), byte_count_((limit - 1) / 30 + 1) {
+    for (auto p : sieving_primes(limit)) {
+      if (p <= wheel_presieve_primes[std::size(wheel_presieve_primes) - 1])
+        continue;
+      if (p < pattern_prime_bound)
+        patterns_.push_back(multiples_pattern(p));
       else
-        l = m;
+        primes_.emplace_back(p, p);
     }
-    return r;
   }
 
-  uint32_t count = primes.size();
-  for (uint32_t i=(primes[primes.size() - 1] + 1); i < limit; i++){
-    if (is_prime(i)){
-      primes.push_back(i);
-      count ++;
+  // Those below limit take bytes [0, (limit - 1) / 30]; only the last one
+  // may be cut.
+  [[nodiscard]] std::uint64_t byte_count() const { return byte_count_; }
+
+  // Writes the bytes [low, low + size) to words. Bits of numbers from limit
+  // on are cleared; trailing bytes of the last word are ANDed with patterns
+  // but otherwise left as they were.
+  void fill(std::uint64_t *words, std::uint64_t low, std::uint64_t size) {
+    auto *bytes = reinterpret_cast<std::uint8_t *>(words);
+    const std::vector<std::uint8_t> &pattern = wheel_presieve_pattern();
+    std::uint64_t from = low % wheel_presieve_bytes;
+    for (std::uint64_t b = 0; b < size;) {
+      const std::uint64_t chunk = std::min(size - b, wheel_presieve_bytes - from);
+      std::copy_n(pattern.begin() + from, chunk, bytes + b);
+      b += chunk;
+      from = 0;
+    }
+
+    const std::uint64_t count = (size + 7) / 8;
+    for (const auto &multiples : patterns_) {
+      const std::uint64_t period = multiples.size();
+      std::uint64_t at = low / 8 % period;
+      for (std::uint64_t w = 0; w < count;) {
+        const std::uint64_t chunk = std::min(count - w, period - at);
+        for (std::uint64_t i = 0; i < chunk; i++)
+          words[w + i] &= multiples[at + i];
+        w += chunk;
+        at = 0;
+      }
+    }
+
+    if (low == 0) {
+      bytes[0] &= static_cast<std::uint8_t>(~1u); // 1 is not a prime
+      for (auto p : wheel_presieve_primes)
+        bytes[0] |= static_cast<std::uint8_t>(1u << wheel_bit[p]);
+      for (const auto &multiples : patterns_) {
+        const std::uint64_t p = multiples.size();
+        bytes[p / 30] |= static_cast<std::uint8_t>(1u << wheel_bit[p % 30]);
+      }
+    }
+
+    for (auto &prime : primes_)
+      prime.cross_off(bytes, low, size);
+
+    if (low + size == byte_count_) {
+      const std::uint64_t last = byte_count_ - 1;
+      for (std::uint32_t k = 0; k < 8; k++) {
+        if (30 * last + wheel_residues[k] >= limit_)
+          bytes[size - 1] &= static_cast<std::uint8_t>(~(1u << k));
+      }
     }
   }
+
+private:
+  // The multiples of p as wheel bytes; as p is odd, a period takes p words.
+  static std::vector<std::uint64_t> multiples_pattern(std::uint32_t p) {
+    std::vector<std::uint64_t> words(p, ~std::uint64_t(0));
+    auto *bytes = reinterpret_cast<std::uint8_t *>(words.data());
+    for (std::uint64_t n = p; n < std::uint64_t(p) * 8 * 30; n += 2 * p) {
+      if (n % 3 != 0 && n % 5 != 0)
+        bytes[n / 30] &= static_cast<std::uint8_t>(~(1u << wheel_bit[n % 30]));
+    }
+    return words;
+  }
+
+  std::uint64_t limit_;
+  std::uint64_t byte_count_;
+  std::vector<std::vector<std::uint64_t>> patterns_;
+  std::vector<wheel_prime> primes_;
+};
+} // namespace
+
+std::size_t count_primes(std::uint32_t limit){
+  if (limit <= 2)
+    return 0;
+
+  std::size_t count = (limit > 3) + (limit > 5) + 1; // 2, 3 and 5
+  if (limit <= 7)
+    return count;
+
+  wheel_sieve sieve(limit);
+  std::vector<std::uint64_t> segment(wheel_segment_bytes / 8);
+  for (std::uint64_t low = 0; low < sieve.byte_count();
+       low += wheel_segment_bytes) {
+    const std::uint64_t size =
+        std::min(wheel_segment_bytes, sieve.byte_count() - low);
+    sieve.fill(segment.data(), low, size);
+    count += count_bits(segment.data(), size * 8);
+  }
   return count;
 }
 
 
-std::int32_t divide(std::int32_t a, std::int32_t b) {
-  int64_t result_64 = 0;
-  bool positive = true;
+prime_table::prime_table(std::uint32_t bound) : bound_(bound) {
+  // One bit past the last number is enough for rank queries at bound.
+  const std::uint64_t bits = std::uint64_t(bound) / 30 * 8 + 8;
+  const std::uint64_t blocks = bits / block_bits + 1;
+  words_.assign(blocks * block_words, 0);
+
+  // Every word past the sieved bytes stays zero, so rank queries need no
+  // bound checks.
+  if (bound > 7) {
+    wheel_sieve sieve(bound);
+    for (std::uint64_t low = 0; low < sieve.byte_count();
+         low += wheel_segment_bytes) {
+      const std::uint64_t size =
+          std::min(wheel_segment_bytes, sieve.byte_count() - low);
+      sieve.fill(words_.data() + low / 8, low, size);
+    }
+  }
+
+  block_counts_.resize(blocks);
+  std::uint32_t count = 0;
+  for (std::uint64_t b = 0; b < blocks; b++) {
+    block_counts_[b] = count;
+    count += static_cast<std::uint32_t>(
+        count_bits(words_.data() + b * block_words, block_bits));
+  }
+}
+
+std::size_t prime_table::count_primes(std::uint32_t limit) const {
+  if (limit > bound_)
+    throw std::out_of_range("Limit " + std::to_string(limit) +
+                            " exceeds the table bound " +
+                            std::to_string(bound_) + ".");
+  if (limit <= 2)
+    return 0;
+
+  // 2, 3 and 5 are not on the wheel; the bits before index stand for the
+  // other numbers up to limit - 1.
+  const std::size_t unwheeled = 1 + (limit > 3) + (limit > 5);
+  const std::uint64_t last = limit - 1;
+  const std::uint64_t index = last / 30 * 8 + wheel_rank[last % 30];
+  const std::uint64_t block = index / block_bits;
+  return unwheeled + block_counts_[block] +
+         count_bits(words_.data() + block * block_words, index % block_bits);
+}
+
+std::uint32_t prime_table::bound() const { return bound_; }
+
+std::vector<std::size_t>
+count_primes_batch(std::span<const std::uint32_t> limits) {
+  if (limits.empty())
+    return {};
+
+  const prime_table table(*std::max_element(limits.begin(), limits.end()));
+  std::vector<std::size_t> result(limits.size());
+  for (std::size_t i = 0; i < limits.size(); i++)
+    result[i] = table.count_primes(limits[i]);
+  return result;
+}
+
+
+namespace {
+// Below this limit y is too small for the leaves to start after the wheel's
+// primes 2, 3 and 5, and sieving is as fast anyway.
+constexpr std::uint64_t sieve_limit = std::uint64_t(1) << 10;
 
-  if (((a > 0) && (b < 0)) || ((a < 0) && (b > 0)))
-    positive = false;
+// The largest r with r^k <= n. The floating-point root may be off by one
+// either way, so it is corrected with exact integer arithmetic.
+std::uint64_t integer_root(std::uint64_t n, int k) {
+  const auto fits = [n, k](std::uint64_t r) {
+    std::uint64_t power = 1;
+    for (int i = 0; i < k; i++) {
+      if (power > n / r)
+        return false;
+      power *= r;
+    }
+    return true;
+  };
+  auto r = static_cast<std::uint64_t>(std::pow(double(n), 1.0 / k));
+  while (r > 1 && !fits(r))
+    r--;
+  while (fits(r + 1))
+    r++;
+  return r;
+}
 
-  auto a_64 = std::int64_t(a);
-  auto b_64 = std::int64_t(b);
+// phi(v, 3): the numbers up to v with no factor 2, 3 or 5.
+std::uint64_t coprime_to_30(std::uint64_t v) {
+  return v / 30 * 8 + wheel_rank[v % 30];
+}
 
-  std::int64_t a_positive_64 = std::abs(a_64);
-  std::int64_t b_positive_64 = std::abs(b_64);
+// Set bits before an index that only grows, counted word by word as it
+// passes them.
+class running_count {
+public:
+  explicit running_count(const std::uint64_t *words) : words_(words) {}
 
-  while (((a_positive_64 - b_positive_64) >= 0) && (a_positive_64 != 0)) {
-    a_positive_64 -= b_positive_64;
-    result_64 += 1;
+  std::uint64_t below(std::uint64_t index) {
+    for (; word_ < index / 64; word_++)
+      count_ += std::popcount(words_[word_]);
+    const std::uint64_t rest = (std::uint64_t(1) << (index % 64)) - 1;
+    return count_ + std::popcount(words_[word_] & rest);
   }
 
-  auto result_32 = int32_t(result_64);
+private:
+  const std::uint64_t *words_;
+  std::uint64_t word_ = 0;
+  std::uint64_t count_ = 0;
+};
+} // namespace
 
-  std::int32_t min_int = std::numeric_limits<std::int32_t>::min();
-  std::int32_t max_int = std::numeric_limits<std::int32_t>::max();
+std::uint64_t count_primes64(std::uint64_t limit) {
+  if (limit <= sieve_limit)
+    return count_primes(static_cast<std::uint32_t>(limit));
 
-  if (result_32 == min_int && positive)
-    return max_int;
+  // Lagarias-Miller-Odlyzko, counting the primes up to x:
+  //   pi(x) = phi(x, a) + a - 1 - P2,  a = pi(y),  x^(1/3) <= y < x^(1/2),
+  // where phi(v, b) counts the numbers up to v with no factor among the
+  // first b primes and P2 counts the products of two primes above y.
+  // phi(x, a) splits into ordinary leaves mu(n) phi(x / n, 3), n <= y, and
+  // special leaves -mu(m) phi(x / (p_b m), b - 1), m <= y < p_b m. The
+  // special ones need phi at arguments below z = x / y, which a sieve of
+  // [1, z] on the wheel provides segment by segment, crossing off one prime
+  // after another. Scaling y up by alpha trades leaves for sieving.
+  const std::uint64_t x = limit - 1;
+  const std::uint64_t root = integer_root(x, 2);
+  const std::uint64_t alpha = std::max<std::uint64_t>(1, std::bit_width(x) / 12);
+  const std::uint64_t y = std::min(integer_root(x, 3) * alpha, root - 1);
+  const std::uint64_t z = x / y;
 
-  if (result_32 == max_int && !positive)
-    return min_int;
+  // primes[b] is the b-th prime, primes[0] a placeholder.
+  std::vector<std::uint32_t> primes = {0, 2};
+  for (auto p : sieving_primes(x + 1))
+    primes.push_back(p);
+
+  // Least prime factor, Moebius function and prime count of 1..y; the least
+  // prime factor of 1 counts as infinite.
+  std::vector<std::uint32_t> lpf(y + 1, 0);
+  std::vector<std::int8_t> mu(y + 1, 1);
+  std::vector<std::uint32_t> pi(y + 1, 0);
+  lpf[1] = std::numeric_limits<std::uint32_t>::max();
+  for (std::uint64_t n = 2; n <= y; n++) {
+    if (lpf[n] == 0)
+      lpf[n] = static_cast<std::uint32_t>(n);
+    for (std::size_t b = 1; b < primes.size() && primes[b] <= lpf[n] &&
+                            n * primes[b] <= y;
+         b++)
+      lpf[n * primes[b]] = primes[b];
+
+    const std::uint64_t rest = n / lpf[n];
+    mu[n] = rest % lpf[n] == 0 ? 0 : static_cast<std::int8_t>(-mu[rest]);
+    pi[n] = pi[n - 1] + (lpf[n] == n);
+  }
+  const std::uint64_t a = pi[y];
+
+  __int128 phi = 0;
+  for (std::uint64_t n = 1; n <= y; n++) {
+    if (mu[n] != 0 && lpf[n] > 5)
+      phi += mu[n] * __int128(coprime_to_30(x / n));
+  }
 
-  return positive ? result_32 : - result_32;
+  // The sieve starts with 2, 3 and 5 crossed off by the wheel, so leaves of
+  // the first three primes are all ordinary ones. sieved[b] counts what is
+  // left of the earlier segments once the primes before p_b are crossed off.
+  std::vector<std::uint64_t> sieved(a, 0);
+  std::vector<wheel_prime> crossers;
+  for (std::uint64_t b = 0; b < a; b++)
+    crossers.emplace_back(std::max<std::uint32_t>(primes[b], 7), 1);
+
+  const std::uint64_t byte_count = z / 30 + 1;
+  std::vector<std::uint64_t> segment(wheel_segment_bytes / 8 + 1);
+  auto *bytes = reinterpret_cast<std::uint8_t *>(segment.data());
+  for (std::uint64_t low = 0; low < byte_count; low += wheel_segment_bytes) {
+    const std::uint64_t size = std::min(wheel_segment_bytes, byte_count - low);
+    std::fill(segment.begin(), segment.end(), ~std::uint64_t(0));
+
+    // Leaves of p_b with x / (p_b m) in the segment have m in (min_m, max_m].
+    const std::uint64_t first = 30 * low;
+    const std::uint64_t end = 30 * (low + size);
+    for (std::uint64_t b = 4; b < a; b++) {
+      const std::uint64_t p = primes[b];
+      const std::uint64_t max_m = first == 0 ? y : std::min(y, x / first / p);
+      const std::uint64_t min_m =
+          std::min(max_m, std::max(y / p, x / end / p));
+      if (max_m <= p)
+        break; // no m with all factors above p; none for later b either
+
+      running_count count(segment.data());
+      const auto leaf = [&](std::uint64_t m) {
+        const std::uint64_t n = x / (p * m);
+        return sieved[b] + count.below((n / 30 - low) * 8 + wheel_rank[n % 30]);
+      };
+      if (p * p <= y) {
+        for (std::uint64_t m = max_m; m > min_m; m--) {
+          if (mu[m] != 0 && lpf[m] > p)
+            phi -= mu[m] * __int128(leaf(m));
+        }
+      } else {
+        // m <= y < p * p, so m is a prime above p.
+        for (std::uint64_t l = pi[max_m]; l > std::max<std::uint64_t>(b, pi[min_m]); l--)
+          phi += leaf(primes[l]);
+      }
+
+      sieved[b] += count.below(size * 8);
+      crossers[b].cross_off(bytes, low, size);
+    }
+  }
+
+  // P2 = sum over primes y < p <= sqrt(x) of pi(x / p) - pi(p) + 1, with
+  // pi(x / p) read off a prime sieve of [1, z] in increasing x / p.
+  std::uint64_t p2 = 0;
+  std::uint64_t b = pi[y];
+  while (b + 1 < primes.size() && primes[b + 1] <= root)
+    b++;
+  wheel_sieve sieve(z + 1);
+  std::uint64_t before = 3; // 2, 3 and 5
+  for (std::uint64_t low = 0; low < byte_count && b > a;
+       low += wheel_segment_bytes) {
+    const std::uint64_t size = std::min(wheel_segment_bytes, byte_count - low);
+    sieve.fill(segment.data(), low, size);
+    running_count count(segment.data());
+    for (; b > a && x / primes[b] < 30 * (low + size); b--) {
+      const std::uint64_t v = x / primes[b];
+      p2 += before + count.below((v / 30 - low) * 8 + wheel_rank[v % 30]) -
+            b + 1;
+    }
+    before += count.below(size * 8);
+  }
+
+  return static_cast<std::uint64_t>(phi + __int128(a) - 1 - __int128(p2));
 }
 
+namespace {
+// Restores the sign of a quotient magnitude; only INT_MIN / -1 does not fit
+// and saturates to INT_MAX.
+std::int32_t signed_quotient(std::uint32_t quotient, bool negative) {
+  const auto max_int =
+      static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max());
+  if (negative)
+    return static_cast<std::int32_t>(0u - quotient);
+  return static_cast<std::int32_t>(std::min(quotient, max_int));
+}
 
-std::map<std::string, unsigned> converter = {{"I",1},
-                                             {"IV",4},
-                                             {"V",5},
-                                             {"IX",9},
-                                             {"X",10},
-                                             {"XL",40},
-                                             {"L",50},
-                                             {"XC",90},
-                                             {"C",100},
-                                             {"CD", 400},
-                                             {"D", 500},
-                                             {"CM", 900},
-                                             {"M",1000}};
+// Binary long division: b is aligned with the top bit of a and then shifted
+// back down, producing one quotient bit per step, at most 32 steps. b must not
+// be 0, or the shift could reach 32.
+std::uint32_t divide_magnitudes(std::uint32_t a, std::uint32_t b) {
+  if (a < b)
+    return 0;
 
-std::vector<std::string> roman_values = {"M", "CM", "D", "CD", "C", "XC",
-                                         "L", "XL", "X", "IX", "V", "IV", "I"};
+  const int shift = std::countl_zero(b) - std::countl_zero(a);
+  std::uint32_t divisor = b << shift;
+  std::uint32_t quotient = 0;
+  for (int bit = shift; bit >= 0; bit--) {
+    if (a >= divisor) {
+      a -= divisor;
+      quotient |= 1u << bit;
+    }
+    divisor >>= 1;
+  }
+  return quotient;
+}
 
+// Lanes processed together by divide_batch. Every lane runs all 32 steps of
+// the restoring division with masks instead of branches, so the inner loops
+// over lanes have a fixed trip count and compile to SIMD.
+constexpr std::size_t divide_lanes = 16;
 
-std::int32_t roman_to_integer(const std::string &number){
-  int32_t result = 0;
+// The body of the block kernels below, inlined into each of them so that it
+// is compiled for their instruction sets.
+[[gnu::always_inline]] inline void
+divide_lanes_kernel(const std::int32_t *a, const std::int32_t *b,
+                    std::int32_t *out) {
+  std::uint32_t dividend[divide_lanes];
+  std::uint32_t divisor[divide_lanes];
+  std::uint32_t remainder[divide_lanes] = {};
+  std::uint32_t quotient[divide_lanes] = {};
 
-  std::string roman_number = number;
+  for (std::size_t l = 0; l < divide_lanes; l++) {
+    dividend[l] = magnitude(a[l]);
+    divisor[l] = magnitude(b[l]);
+  }
 
-  for (auto & c : roman_values){
-    while (roman_number.rfind(c, 0) == 0){
-      result += converter[c];
-      roman_number = roman_number.substr(c.size(), roman_number.size()-c.size());
+  // The dividend is shifted out from the top one bit per step, and the
+  // quotient shifted in from the bottom, so no lane needs a variable shift.
+  // At -O3 a fully unrolled lane loop is no longer vectorized, hence the
+  // pragma.
+  for (int step = 0; step < 32; step++) {
+#pragma GCC unroll 1
+    for (std::size_t l = 0; l < divide_lanes; l++) {
+      remainder[l] = (remainder[l] << 1) | (dividend[l] >> 31);
+      dividend[l] <<= 1;
+      const std::uint32_t take = 0u - std::uint32_t(remainder[l] >= divisor[l]);
+      remainder[l] -= divisor[l] & take;
+      quotient[l] = (quotient[l] << 1) | (take & 1u);
     }
   }
+
+  // Same as signed_quotient, spelled with masks: a quotient never exceeds
+  // 2^31, so subtracting its top bit saturates 2^31 to INT_MAX.
+  for (std::size_t l = 0; l < divide_lanes; l++) {
+    const std::uint32_t negative =
+        0u - (static_cast<std::uint32_t>(a[l] ^ b[l]) >> 31);
+    const std::uint32_t positive = quotient[l] - (quotient[l] >> 31);
+    out[l] = static_cast<std::int32_t>(((0u - quotient[l]) & negative) |
+                                       (positive & ~negative));
+  }
+}
+
+void divide_lanes_block(const std::int32_t *a, const std::int32_t *b,
+                        std::int32_t *out) {
+  divide_lanes_kernel(a, b, out);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// The baseline x86-64 build has 4 lanes per register, AVX2 has 8. On random
+// inputs this copy is about 2.5 times as fast as divide, the baseline one
+// only a fifth faster.
+[[gnu::target("avx2")]] void divide_lanes_block_avx2(const std::int32_t *a,
+                                                     const std::int32_t *b,
+                                                     std::int32_t *out) {
+  divide_lanes_kernel(a, b, out);
+}
+
+bool avx2_supported() {
+  static const bool result = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }();
+  return result;
+}
+#endif
+} // namespace
+
+std::int32_t divide(std::int32_t a, std::int32_t b) {
+  if (b == 0)
+    throw std::invalid_argument("divide: division by zero.");
+  return signed_quotient(divide_magnitudes(magnitude(a), magnitude(b)),
+                         (a ^ b) < 0);
+}
+
+void divide_batch(std::span<const std::int32_t> a,
+                  std::span<const std::int32_t> b,
+                  std::span<std::int32_t> out) {
+  if (a.size() != b.size() || a.size() != out.size())
+    throw std::invalid_argument("divide_batch: spans must have equal sizes.");
+  if (std::find(b.begin(), b.end(), 0) != b.end())
+    throw std::invalid_argument("divide_batch: division by zero.");
+
+  auto block = divide_lanes_block;
+#if defined(__x86_64__) || defined(__i386__)
+  if (avx2_supported())
+    block = divide_lanes_block_avx2;
+#endif
+
+  std::size_t i = 0;
+  for (; i + divide_lanes <= a.size(); i += divide_lanes)
+    block(a.data() + i, b.data() + i, out.data() + i);
+  for (; i < a.size(); i++)
+    out[i] = divide(a[i], b[i]);
+}
+
+
+divider::divider(std::int32_t divisor) : divisor_(divisor) {
+  if (divisor == 0)
+    throw std::invalid_argument("divider: division by zero.");
+
+  const std::uint32_t d = magnitude(divisor);
+  const std::uint32_t s = d == 1 ? 0 : 32 - std::countl_zero(d - 1);
+  const std::uint64_t power = std::uint64_t(1) << (31 + s);
+
+  magic_ = static_cast<std::uint32_t>((power + d - 1) / d);
+  shift_ = 31 + s;
+  sign_ = divisor < 0 ? ~0u : 0u;
+}
+
+void divider::operator()(std::span<const std::int32_t> a,
+                         std::span<std::int32_t> out) const {
+  if (a.size() != out.size())
+    throw std::invalid_argument("divider: spans must have equal sizes.");
+
+  // A local copy keeps the loop free of loads through this, so it vectorizes.
+  const divider self = *this;
+  for (std::size_t i = 0; i < a.size(); i++)
+    out[i] = self(a[i]);
+}
+
+std::int32_t divider::divisor() const { return divisor_; }
+
+
+namespace {
+// value of a symbol on its own, and the smallest value of a symbol or
+// subtractive pair that is larger than it ("I" -> "IV", "V" -> "IX", ...).
+struct roman_symbol {
+  std::uint16_t value;
+  std::uint16_t next;
+};
+
+constexpr std::array<roman_symbol, 256> roman_symbols = [] {
+  std::array<roman_symbol, 256> table{};
+  table['I'] = {1, 4};
+  table['V'] = {5, 9};
+  table['X'] = {10, 40};
+  table['L'] = {50, 90};
+  table['C'] = {100, 400};
+  table['D'] = {500, 900};
+  table['M'] = {1000, 4000};
+  return table;
+}();
+} // namespace
+
+std::int32_t roman_to_integer(std::string_view number, std::error_code &ec) {
+  ec.clear();
+
+  // A numeral is canonical iff every token (a symbol or a subtractive pair)
+  // is the largest one that fits into the value of the rest of the numeral,
+  // i.e. every token together with everything after it stays below the next
+  // larger token. budget is the tightest such bound seen so far.
+  std::uint32_t result = 0;
+  std::uint32_t budget = 4000;
+
+  for (std::size_t i = 0; i < number.size();) {
+    const roman_symbol current =
+        roman_symbols[static_cast<unsigned char>(number[i])];
+    if (current.value == 0) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return 0;
+    }
+
+    std::uint32_t value = current.value;
+    std::uint32_t next = current.next;
+    i++;
+
+    if (i < number.size()) {
+      const roman_symbol following =
+          roman_symbols[static_cast<unsigned char>(number[i])];
+      if (following.value > current.value) {
+        // Only I, X and C subtract, and only from the next two symbols.
+        if (current.next != 4 * current.value ||
+            following.value > 10 * current.value) {
+          ec = std::make_error_code(std::errc::invalid_argument);
+          return 0;
+        }
+        value = following.value - current.value;
+        next = following.value;
+        i++;
+      }
+    }
+
+    if (value >= budget) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return 0;
+    }
+    budget = std::min(budget - value, next - value);
+    result += value;
+  }
+  return static_cast<std::int32_t>(result);
+}
+
+std::int32_t roman_to_integer(std::string_view number) {
+  std::error_code ec;
+  const std::int32_t result = roman_to_integer(number, ec);
+  if (ec)
+    throw std::invalid_argument("Malformed roman numeral: " +
+                                std::string(number) + ".");
   return result;
 }
+
+namespace {
+// Every numeral of 0..3999 spelled out at compile time; the longest one,
+// MMMDCCCLXXXVIII, has 15 characters, so an entry fits into 16 bytes.
+struct roman_text {
+  char text[15];
+  std::uint8_t size;
+};
+
+constexpr std::array<roman_text, 4000> roman_texts = [] {
+  constexpr std::int32_t values[] = {1000, 900, 500, 400, 100, 90, 50,
+                                     40,   10,  9,   5,   4,   1};
+  constexpr const char *symbols[] = {"M",  "CM", "D",  "CD", "C",
+                                     "XC", "L",  "XL", "X",  "IX",
+                                     "V",  "IV", "I"};
+
+  std::array<roman_text, 4000> table{};
+  for (std::int32_t number = 1; number < 4000; number++) {
+    roman_text &entry = table[number];
+    std::int32_t rest = number;
+    for (std::size_t k = 0; k < std::size(values); k++) {
+      for (; rest >= values[k]; rest -= values[k]) {
+        for (const char *c = symbols[k]; *c != '\0'; c++)
+          entry.text[entry.size++] = *c;
+      }
+    }
+  }
+  return table;
+}();
+} // namespace
+
+std::string_view integer_to_roman(std::int32_t number) {
+  if (number < 0 || number >= std::int32_t(roman_texts.size()))
+    throw std::out_of_range("Number " + std::to_string(number) +
+                            " has no roman numeral.");
+  const roman_text &entry = roman_texts[number];
+  return {entry.text, entry.size};
+}
 } // namespace mse
@@ -1,16 +1,110 @@
 #pragma once
 
+#include <cstdint>
 #include <numeric>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 namespace mse {
 
 [[nodiscard]] std::size_t sum_digits(std::int32_t number);
 
+// out[i] = sum_digits(numbers[i]); both spans must have the same size.
+void sum_digits_batch(std::span<const std::int32_t> numbers,
+                      std::span<std::size_t> out);
+
+// Deterministic for every 64-bit n: trial division by small primes, then
+// Miller-Rabin with witness sets known to have no strong pseudoprimes.
+[[nodiscard]] bool is_prime(std::uint64_t n);
+
 [[nodiscard]] std::size_t count_primes(std::uint32_t limit);
 
+// The primes below limit, by the Lagarias-Miller-Odlyzko method: about
+// limit^(2/3) time and limit^(1/2) memory, e.g. 0.2 s for 10^12.
+[[nodiscard]] std::uint64_t count_primes64(std::uint64_t limit);
+
+// Prime bitset for all numbers below bound, one bit per number coprime to 30,
+// sieved once in the constructor by the same engine as mse::count_primes and
+// read-only afterwards, so one table can be shared by any number of threads
+// without locking. Every 512-bit block keeps the count of primes before it,
+// which makes count_primes a lookup plus a few popcounts.
+class prime_table {
+public:
+  explicit prime_table(std::uint32_t bound);
+
+  // Number of primes strictly less than limit, limit <= bound().
+  [[nodiscard]] std::size_t count_primes(std::uint32_t limit) const;
+
+  [[nodiscard]] std::uint32_t bound() const;
+
+private:
+  static constexpr std::uint64_t block_words = 8;
+  static constexpr std::uint64_t block_bits = block_words * 64;
+
+  std::uint32_t bound_;
+  std::vector<std::uint64_t> words_;
+  std::vector<std::uint32_t> block_counts_;
+};
+
+// Answers count_primes for every limit from a single sieve pass.
+[[nodiscard]] std::vector<std::size_t>
+count_primes_batch(std::span<const std::uint32_t> limits);
+
+// a / b rounded toward zero; INT_MIN / -1 saturates to INT_MAX. Throws
+// std::invalid_argument if b is 0.
 [[nodiscard]] std::int32_t divide(std::int32_t a, std::int32_t b);
 
-[[nodiscard]] std::int32_t roman_to_integer(const std::string &number);
+// out[i] = divide(a[i], b[i]); all three spans must have the same size.
+// Throws std::invalid_argument, before writing anything, if any b[i] is 0.
+void divide_batch(std::span<const std::int32_t> a,
+                  std::span<const std::int32_t> b,
+                  std::span<std::int32_t> out);
+
+// Division by a divisor fixed at construction. The divisor magnitude d is
+// replaced by a 32-bit magic number m = ceil(2^(31 + s) / d) with
+// 2^(s - 1) < d <= 2^s, so |a| / d == (|a| * m) >> (31 + s) for every
+// |a| <= 2^31. Results match divide exactly, including INT_MIN / -1.
+class divider {
+public:
+  explicit divider(std::int32_t divisor);
+
+  [[nodiscard]] std::int32_t operator()(std::int32_t a) const {
+    const std::uint32_t sign = a < 0 ? ~0u : 0u;
+    const std::uint32_t dividend = (static_cast<std::uint32_t>(a) ^ sign) - sign;
+    const auto quotient = static_cast<std::uint32_t>(
+        (std::uint64_t(dividend) * magic_) >> shift_);
+    const std::uint32_t negative = sign ^ sign_;
+    const std::uint32_t positive = quotient - (quotient >> 31);
+    return static_cast<std::int32_t>(((0u - quotient) & negative) |
+                                     (positive & ~negative));
+  }
+
+  // out[i] = (*this)(a[i]); both spans must have the same size.
+  void operator()(std::span<const std::int32_t> a,
+                  std::span<std::int32_t> out) const;
+
+  [[nodiscard]] std::int32_t divisor() const;
+
+private:
+  std::int32_t divisor_;
+  std::uint32_t magic_;
+  std::uint32_t shift_;
+  std::uint32_t sign_; // all ones for a negative divisor
+};
+
+// Parses a canonical roman numeral in [1, 3999]; the empty string is 0.
+// Malformed input throws std::invalid_argument.
+[[nodiscard]] std::int32_t roman_to_integer(std::string_view number);
+
+// Same, but reports malformed input through ec and returns 0.
+[[nodiscard]] std::int32_t roman_to_integer(std::string_view number,
+                                            std::error_code &ec);
+
+// Canonical roman numeral of a number in [0, 3999] (0 is the empty string),
+// viewing a static table. Other numbers throw std::out_of_range.
+[[nodiscard]] std::string_view integer_to_roman(std::int32_t number);
 
 } // namespace mse
@@ -0,0 +1,172 @@
+#include "roman_codec.h"
+#include "numbers.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mse {
+
+mapped_file::mapped_file(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to open file: " + path);
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::generic_category(),
+                            "Failed to stat file: " + path);
+  }
+
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ != 0) {
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data_ == MAP_FAILED) {
+      const int error = errno;
+      ::close(fd);
+      data_ = nullptr;
+      throw std::system_error(error, std::generic_category(),
+                              "Failed to map file: " + path);
+    }
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+  ::close(fd);
+}
+
+mapped_file::~mapped_file() {
+  if (data_ != nullptr)
+    ::munmap(data_, size_);
+}
+
+mapped_file::mapped_file(mapped_file &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr)
+      ::munmap(data_, size_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+std::string_view mapped_file::view() const {
+  return {static_cast<const char *>(data_), size_};
+}
+
+std::size_t count_records(std::string_view text) {
+  const auto lines =
+      static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+  return lines + (!text.empty() && text.back() != '\n');
+}
+
+namespace {
+// Below this size one thread parses faster than several can be started.
+constexpr std::size_t min_bytes_per_thread = std::size_t(1) << 16;
+
+// Runs work(0), ..., work(parts - 1) on separate threads, one of them being
+// the calling thread.
+template <typename Work> void run_parallel(std::size_t parts, Work &&work) {
+  std::vector<std::thread> workers;
+  workers.reserve(parts - 1);
+  for (std::size_t k = 1; k < parts; k++)
+    workers.emplace_back(work, k);
+  work(0);
+  for (auto &worker : workers)
+    worker.join();
+}
+
+std::size_t parse_records(std::string_view text, std::int32_t *out) {
+  std::size_t malformed = 0;
+  while (!text.empty()) {
+    const std::size_t end = std::min(text.find('\n'), text.size());
+    std::string_view line = text.substr(0, end);
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+
+    std::error_code ec;
+    *out = roman_to_integer(line, ec);
+    if (ec) {
+      *out = -1;
+      malformed++;
+    }
+    out++;
+    text.remove_prefix(std::min(end + 1, text.size()));
+  }
+  return malformed;
+}
+} // namespace
+
+std::size_t roman_to_integer_bulk(std::string_view text,
+                                  std::span<std::int32_t> out,
+                                  unsigned threads) {
+  const std::size_t most = std::max<std::size_t>(
+      1, text.size() / min_bytes_per_thread);
+  const std::size_t parts = std::clamp<std::size_t>(threads, 1, most);
+
+  // Byte ranges of roughly equal size, each one ending right after a newline
+  // (or at the end of the text), so no record straddles two ranges.
+  std::vector<std::size_t> bounds(parts + 1, text.size());
+  bounds[0] = 0;
+  for (std::size_t k = 1; k < parts; k++) {
+    const std::size_t from =
+        std::max(bounds[k - 1], k * (text.size() / parts));
+    const std::size_t newline = text.find('\n', from);
+    bounds[k] = newline == std::string_view::npos ? text.size() : newline + 1;
+  }
+
+  auto range = [&](std::size_t k) {
+    return text.substr(bounds[k], bounds[k + 1] - bounds[k]);
+  };
+
+  std::vector<std::size_t> offsets(parts + 1, 0);
+  run_parallel(parts,
+               [&](std::size_t k) { offsets[k + 1] = count_records(range(k)); });
+  for (std::size_t k = 0; k < parts; k++)
+    offsets[k + 1] += offsets[k];
+  if (offsets[parts] != out.size())
+    throw std::invalid_argument(
+        "roman_to_integer_bulk: output size does not match record count.");
+
+  std::vector<std::size_t> malformed(parts, 0);
+  run_parallel(parts, [&](std::size_t k) {
+    malformed[k] = parse_records(range(k), out.data() + offsets[k]);
+  });
+
+  std::size_t total = 0;
+  for (auto count : malformed)
+    total += count;
+  return total;
+}
+
+std::string integer_to_roman_bulk(std::span<const std::int32_t> values) {
+  std::size_t size = 0;
+  for (auto value : values)
+    size += integer_to_roman(value).size() + 1;
+
+  std::string result(size, '\n');
+  char *cursor = result.data();
+  for (auto value : values) {
+    const std::string_view numeral = integer_to_roman(value);
+    std::memcpy(cursor, numeral.data(), numeral.size());
+    cursor += numeral.size() + 1;
+  }
+  return result;
+}
+
+} // namespace mse
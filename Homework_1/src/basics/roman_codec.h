@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace mse {
+
+// Read-only memory mapping of a whole file. Throws std::system_error if the
+// file cannot be opened or mapped.
+class mapped_file {
+public:
+  explicit mapped_file(const std::string &path);
+  ~mapped_file();
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+  mapped_file(mapped_file &&other) noexcept;
+  mapped_file &operator=(mapped_file &&other) noexcept;
+
+  [[nodiscard]] std::string_view view() const;
+
+private:
+  void *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Number of newline-separated records in text. A trailing newline does not
+// start another record, and a trailing '\r' is part of the line ending.
+[[nodiscard]] std::size_t count_records(std::string_view text);
+
+// Parses every record of text as a roman numeral into out, which must hold
+// exactly count_records(text) values. The text is split into byte ranges at
+// line boundaries, one per thread. Malformed records are stored as -1;
+// returns how many there were.
+std::size_t roman_to_integer_bulk(std::string_view text,
+                                  std::span<std::int32_t> out,
+                                  unsigned threads);
+
+// Encodes values in [0, 3999] as roman numerals, one per line.
+[[nodiscard]] std::string
+integer_to_roman_bulk(std::span<const std::int32_t> values);
+
+} // namespace mse
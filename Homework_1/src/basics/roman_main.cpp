@@ -0,0 +1,105 @@
+#include "numbers.h"
+#include "roman_codec.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void print_usage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " --decode|--encode <file> [--threads N]" << std::endl;
+}
+
+void write_all(std::string_view text) {
+  std::fwrite(text.data(), 1, text.size(), stdout);
+}
+
+// Roman numerals to integers, one per line; malformed lines become -1.
+int decode(std::string_view text, unsigned threads) {
+  std::vector<std::int32_t> values(mse::count_records(text));
+  const std::size_t malformed =
+      mse::roman_to_integer_bulk(text, values, threads);
+
+  std::string output;
+  output.reserve(values.size() * 5);
+  char buffer[16];
+  for (auto value : values) {
+    const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    output.append(buffer, end);
+    output.push_back('\n');
+  }
+  write_all(output);
+
+  if (malformed != 0) {
+    std::cerr << malformed << " malformed roman numeral(s)." << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Integers in [0, 3999] to roman numerals, one per line.
+int encode(std::string_view text) {
+  std::vector<std::int32_t> values;
+  values.reserve(mse::count_records(text));
+
+  while (!text.empty()) {
+    const std::size_t end = std::min(text.find('\n'), text.size());
+    std::string_view line = text.substr(0, end);
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+
+    std::int32_t value = 0;
+    const auto [rest, ec] =
+        std::from_chars(line.data(), line.data() + line.size(), value);
+    if (ec != std::errc() || rest != line.data() + line.size())
+      throw std::invalid_argument("Not an integer: " + std::string(line) +
+                                  ".");
+    values.push_back(value);
+    text.remove_prefix(std::min(end + 1, text.size()));
+  }
+
+  write_all(mse::integer_to_roman_bulk(values));
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 3 && argc != 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  const bool decoding = std::strcmp(argv[1], "--decode") == 0;
+  if (!decoding && std::strcmp(argv[1], "--encode") != 0) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  if (argc == 5) {
+    const std::string_view count = argv[4];
+    const auto [rest, ec] =
+        std::from_chars(count.data(), count.data() + count.size(), threads);
+    if (std::strcmp(argv[3], "--threads") != 0 || ec != std::errc() ||
+        rest != count.data() + count.size() || threads == 0) {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  try {
+    const mse::mapped_file file(argv[2]);
+    return decoding ? decode(file.view(), threads) : encode(file.view());
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,352 @@
+// Microbenchmarks for the Homework_1 numeric library.
+//
+// Usage: numbers_bench [--filter <substring>] [--min-time <seconds>]
+//                      [--json <file>]
+//
+// Every benchmark runs once untimed, then repeatedly until min-time has
+// elapsed (at least once), and reports ns/op and ops/s; --json additionally
+// writes the results in machine-readable form for comparing builds.
+
+#include <basics/numbers.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+struct benchmark {
+  std::string name;
+  // Operations performed by one call of run.
+  std::size_t ops;
+  // Returns a checksum, so that the work cannot be optimized away.
+  std::function<std::uint64_t()> run;
+};
+
+struct result {
+  std::string name;
+  std::size_t iterations;
+  double ns_per_op;
+  double ops_per_second;
+};
+
+volatile std::uint64_t sink = 0;
+
+class random_source {
+public:
+  explicit random_source(std::uint64_t seed) : state_(seed) {}
+
+  std::uint64_t next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 7;
+    state_ ^= state_ << 17;
+    return state_;
+  }
+
+private:
+  std::uint64_t state_;
+};
+
+std::vector<std::int32_t> random_int32(std::size_t count, std::uint64_t seed) {
+  random_source source(seed);
+  std::vector<std::int32_t> values(count);
+  for (auto &value : values)
+    value = static_cast<std::int32_t>(source.next());
+  return values;
+}
+
+std::vector<std::int32_t> random_divisors(std::size_t count,
+                                          std::uint64_t seed) {
+  std::vector<std::int32_t> values = random_int32(count, seed);
+  for (auto &value : values) {
+    if (value == 0)
+      value = 1;
+  }
+  return values;
+}
+
+std::string limit_name(double limit) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.0e", limit);
+  return buffer;
+}
+
+void add_count_primes(std::vector<benchmark> &benchmarks) {
+  for (double limit : {1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 4e9}) {
+    const auto value = static_cast<std::uint32_t>(limit);
+    benchmarks.push_back({"count_primes/" + limit_name(limit), 1,
+                          [value] { return mse::count_primes(value); }});
+  }
+  for (double limit : {1e6, 1e9, 1e10, 1e11, 1e12}) {
+    const auto value = static_cast<std::uint64_t>(limit);
+    benchmarks.push_back({"count_primes64/" + limit_name(limit), 1,
+                          [value] { return mse::count_primes64(value); }});
+  }
+
+  const std::size_t queries = 1 << 16;
+  benchmarks.push_back({"count_primes_batch/1e8", queries, [] {
+                          random_source source(7);
+                          std::vector<std::uint32_t> limits(queries);
+                          for (auto &limit : limits)
+                            limit = source.next() % 100000000;
+                          std::uint64_t sum = 0;
+                          for (auto count : mse::count_primes_batch(limits))
+                            sum += count;
+                          return sum;
+                        }});
+
+  benchmarks.push_back({"prime_table_query/1e8", queries, [] {
+                          // Built by the first run only, and only if the
+                          // benchmark is not filtered out.
+                          static const mse::prime_table table(100000000);
+                          random_source source(11);
+                          std::uint64_t sum = 0;
+                          for (std::size_t i = 0; i < queries; i++)
+                            sum += table.count_primes(
+                                source.next() % 100000000);
+                          return sum;
+                        }});
+}
+
+void add_is_prime(std::vector<benchmark> &benchmarks) {
+  const std::size_t count = 1 << 14;
+  benchmarks.push_back({"is_prime/random32", count, [] {
+                          random_source source(3);
+                          std::uint64_t primes = 0;
+                          for (std::size_t i = 0; i < count; i++)
+                            primes += mse::is_prime(source.next() >> 32);
+                          return primes;
+                        }});
+  benchmarks.push_back({"is_prime/random64", count, [] {
+                          random_source source(5);
+                          std::uint64_t primes = 0;
+                          for (std::size_t i = 0; i < count; i++)
+                            primes += mse::is_prime(source.next());
+                          return primes;
+                        }});
+  benchmarks.push_back({"is_prime/prime64", count, [] {
+                          std::uint64_t primes = 0;
+                          for (std::size_t i = 0; i < count; i++)
+                            primes += mse::is_prime(18446744073709551557ull);
+                          return primes;
+                        }});
+}
+
+void add_divide(std::vector<benchmark> &benchmarks) {
+  const std::int32_t min_int = std::numeric_limits<std::int32_t>::min();
+  const std::int32_t max_int = std::numeric_limits<std::int32_t>::max();
+  const std::size_t count = 1 << 16;
+
+  struct adversarial {
+    const char *name;
+    std::int32_t a;
+    std::int32_t b;
+  };
+  for (const adversarial &input : {adversarial{"max_by_1", max_int, 1},
+                                   adversarial{"min_by_-1", min_int, -1},
+                                   adversarial{"min_by_min", min_int, min_int},
+                                   adversarial{"1_by_max", 1, max_int}}) {
+    const std::int32_t a = input.a;
+    const std::int32_t b = input.b;
+    benchmarks.push_back({std::string("divide/") + input.name, count, [a, b] {
+                            std::uint64_t sum = 0;
+                            for (std::size_t i = 0; i < count; i++)
+                              sum += mse::divide(a, b);
+                            return sum;
+                          }});
+  }
+
+  auto a = std::make_shared<std::vector<std::int32_t>>(random_int32(count, 13));
+  auto b = std::make_shared<std::vector<std::int32_t>>(
+      random_divisors(count, 17));
+  auto out = std::make_shared<std::vector<std::int32_t>>(count);
+
+  benchmarks.push_back({"divide/random", count, [a, b] {
+                          std::uint64_t sum = 0;
+                          for (std::size_t i = 0; i < count; i++)
+                            sum += mse::divide((*a)[i], (*b)[i]);
+                          return sum;
+                        }});
+  benchmarks.push_back({"divide_batch/random", count, [a, b, out] {
+                          mse::divide_batch(*a, *b, *out);
+                          return std::uint64_t((*out)[count / 2]);
+                        }});
+  benchmarks.push_back({"divider/random", count, [a, out] {
+                          const mse::divider divider(7919);
+                          divider(*a, *out);
+                          return std::uint64_t((*out)[count / 2]);
+                        }});
+}
+
+// sum_digits as it was before it became arithmetic, kept as the baseline.
+std::size_t sum_digits_to_string(std::int32_t number) {
+  const std::string s = std::to_string(number);
+  std::size_t sum = 0;
+  for (char c : s) {
+    if (c != '-')
+      sum += c - '0';
+  }
+  return sum;
+}
+
+void add_sum_digits(std::vector<benchmark> &benchmarks) {
+  const std::size_t count = 1 << 16;
+  auto values =
+      std::make_shared<std::vector<std::int32_t>>(random_int32(count, 19));
+  auto out = std::make_shared<std::vector<std::size_t>>(count);
+
+  benchmarks.push_back({"sum_digits_to_string/random", count, [values] {
+                          std::uint64_t sum = 0;
+                          for (auto value : *values)
+                            sum += sum_digits_to_string(value);
+                          return sum;
+                        }});
+  benchmarks.push_back({"sum_digits/random", count, [values] {
+                          std::uint64_t sum = 0;
+                          for (auto value : *values)
+                            sum += mse::sum_digits(value);
+                          return sum;
+                        }});
+  benchmarks.push_back({"sum_digits_batch/random", count, [values, out] {
+                          mse::sum_digits_batch(*values, *out);
+                          return std::uint64_t((*out)[count / 2]);
+                        }});
+}
+
+void add_roman(std::vector<benchmark> &benchmarks) {
+  const std::size_t count = 1 << 14;
+  random_source source(23);
+  auto random = std::make_shared<std::vector<std::string>>();
+  for (std::size_t i = 0; i < count; i++) {
+    const auto number = static_cast<std::int32_t>(1 + source.next() % 3999);
+    random->emplace_back(mse::integer_to_roman(number));
+  }
+
+  benchmarks.push_back({"roman_to_integer/random", count, [random] {
+                          std::uint64_t sum = 0;
+                          for (const auto &numeral : *random)
+                            sum += mse::roman_to_integer(numeral);
+                          return sum;
+                        }});
+  benchmarks.push_back({"roman_to_integer/longest", count, [] {
+                          std::uint64_t sum = 0;
+                          for (std::size_t i = 0; i < count; i++)
+                            sum += mse::roman_to_integer("MMMDCCCLXXXVIII");
+                          return sum;
+                        }});
+  benchmarks.push_back({"roman_to_integer/malformed", count, [] {
+                          std::uint64_t errors = 0;
+                          for (std::size_t i = 0; i < count; i++) {
+                            std::error_code ec;
+                            (void)mse::roman_to_integer("MMMCMXCIXI", ec);
+                            errors += static_cast<bool>(ec);
+                          }
+                          return errors;
+                        }});
+  benchmarks.push_back({"integer_to_roman/all", 3999, [] {
+                          std::uint64_t size = 0;
+                          for (std::int32_t n = 1; n < 4000; n++)
+                            size += mse::integer_to_roman(n).size();
+                          return size;
+                        }});
+}
+
+result measure(const benchmark &bench, double min_time) {
+  using clock = std::chrono::steady_clock;
+
+  // One untimed run first, so lazily built data and cold caches do not count.
+  sink = sink + bench.run();
+
+  std::size_t runs = 0;
+  const auto start = clock::now();
+  double elapsed = 0;
+  do {
+    sink = sink + bench.run();
+    runs++;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  } while (elapsed < min_time);
+
+  const double ops = double(runs) * double(bench.ops);
+  return {bench.name, runs, elapsed * 1e9 / ops, ops / elapsed};
+}
+
+void write_json(const std::string &path, const std::vector<result> &results) {
+  std::ofstream file(path);
+  if (!file)
+    throw std::invalid_argument("Failed to open file: " + path + ".");
+
+  file << "{\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const result &r = results[i];
+    file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name
+         << "\", \"iterations\": " << r.iterations
+         << ", \"ns_per_op\": " << r.ns_per_op
+         << ", \"ops_per_second\": " << r.ops_per_second << "}";
+  }
+  file << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string filter;
+  std::string json_path;
+  double min_time = 0.5;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      min_time = std::atof(argv[++i]);
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--filter <substring>] [--min-time <seconds>]"
+                   " [--json <file>]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<benchmark> benchmarks;
+  add_count_primes(benchmarks);
+  add_is_prime(benchmarks);
+  add_divide(benchmarks);
+  add_sum_digits(benchmarks);
+  add_roman(benchmarks);
+
+  std::vector<result> results;
+  std::printf("%-32s %12s %14s %16s\n", "benchmark", "iterations", "ns/op",
+              "ops/s");
+  for (const auto &bench : benchmarks) {
+    if (bench.name.find(filter) == std::string::npos)
+      continue;
+    results.push_back(measure(bench, min_time));
+    const result &r = results.back();
+    std::printf("%-32s %12zu %14.2f %16.0f\n", r.name.c_str(), r.iterations,
+                r.ns_per_op, r.ops_per_second);
+    std::fflush(stdout);
+  }
+
+  if (!json_path.empty()) {
+    try {
+      write_json(json_path, results);
+    } catch (const std::exception &error) {
+      std::cerr << error.what() << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -33,3 +33,47 @@ TEST_CASE("count_primes_4321", "[count_primes]") {
 TEST_CASE("count_primes_54321", "[count_primes]") {
   REQUIRE(count_primes(54321) == 5525);
 }
+
+TEST_CASE("count_primes_every_limit_below_1000", "[count_primes]") {
+  for (std::uint32_t limit = 0; limit < 1000; limit++)
+    REQUIRE(count_primes(limit) == count_primes64(limit));
+}
+
+TEST_CASE("count_primes_uint32_max", "[count_primes]") {
+  REQUIRE(count_primes(4294967295u) == 203280221);
+}
+
+TEST_CASE("count_primes64_matches_count_primes", "[count_primes64]") {
+  for (std::uint32_t limit :
+       {0u, 1u, 2u, 3u, 4u, 7u, 12u, 123u, 1234u, 4321u, 54321u, 10000019u}) {
+    REQUIRE(count_primes64(limit) == count_primes(limit));
+  }
+}
+
+TEST_CASE("count_primes64_every_limit_from_1000_to_3000", "[count_primes64]") {
+  for (std::uint32_t limit = 1000; limit <= 3000; limit++)
+    REQUIRE(count_primes64(limit) == count_primes(limit));
+}
+
+TEST_CASE("count_primes64_around_prime_squares", "[count_primes64]") {
+  for (std::uint32_t p : {1009u, 7919u, 65521u}) {
+    for (std::uint32_t limit : {p * p - 1, p * p, p * p + 1, p * p + 2})
+      REQUIRE(count_primes64(limit) == count_primes(limit));
+  }
+}
+
+TEST_CASE("count_primes64_uint32_max", "[count_primes64]") {
+  REQUIRE(count_primes64(4294967296ull) == 203280221);
+}
+
+TEST_CASE("count_primes64_powers_of_ten", "[count_primes64]") {
+  const std::uint64_t expected[] = {0,       4,        25,        168,
+                                    1229,    9592,     78498,     664579,
+                                    5761455, 50847534, 455052511, 4118054813,
+                                    37607912018};
+  std::uint64_t limit = 1;
+  for (auto pi : expected) {
+    REQUIRE(count_primes64(limit) == pi);
+    limit *= 10;
+  }
+}
@@ -2,6 +2,9 @@
 
 #include <basics/numbers.h>
 
+#include <stdexcept>
+#include <vector>
+
 using namespace mse;
 
 TEST_CASE("divide_0_any", "[devide]") { REQUIRE(divide(0, 123) == 0); }
@@ -96,3 +99,63 @@ TEST_CASE("divide_min_max", "[devide]") {
   REQUIRE(divide(std::numeric_limits<int>::min(),
                  std::numeric_limits<int>::max()) == -1);
 }
+
+TEST_CASE("divide_max_-1", "[devide]") {
+  REQUIRE(divide(std::numeric_limits<int>::max(), -1) ==
+          -std::numeric_limits<int>::max());
+}
+
+TEST_CASE("divide_min_2", "[devide]") {
+  REQUIRE(divide(std::numeric_limits<int>::min(), 2) == -(1 << 30));
+}
+
+TEST_CASE("divide_batch_matches_divide", "[devide]") {
+  const std::int32_t min_int = std::numeric_limits<std::int32_t>::min();
+  const std::int32_t max_int = std::numeric_limits<std::int32_t>::max();
+  const std::vector<std::int32_t> values = {
+      min_int, min_int + 1, -123456789, -321, -5, -2, -1, 0,
+      1,       2,           5,          7,    321, 123456789, max_int - 1,
+      max_int};
+
+  std::vector<std::int32_t> a;
+  std::vector<std::int32_t> b;
+  for (auto x : values) {
+    for (auto y : values) {
+      if (y != 0) {
+        a.push_back(x);
+        b.push_back(y);
+      }
+    }
+  }
+
+  std::vector<std::int32_t> out(a.size());
+  divide_batch(a, b, out);
+  for (std::size_t i = 0; i < a.size(); i++) {
+    const std::int64_t exact = std::int64_t(a[i]) / b[i];
+    const std::int64_t expected = exact > max_int ? max_int : exact;
+    REQUIRE(out[i] == expected);
+    REQUIRE(divide(a[i], b[i]) == expected);
+  }
+}
+
+TEST_CASE("divide_batch_size_mismatch", "[devide]") {
+  std::vector<std::int32_t> a = {1, 2, 3};
+  std::vector<std::int32_t> b = {1, 2};
+  std::vector<std::int32_t> out(3);
+  REQUIRE_THROWS_AS(divide_batch(a, b, out), std::invalid_argument);
+}
+
+TEST_CASE("divide_by_zero", "[devide]") {
+  REQUIRE_THROWS_AS(divide(1, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(divide(std::numeric_limits<std::int32_t>::min(), 0),
+                    std::invalid_argument);
+}
+
+TEST_CASE("divide_batch_by_zero", "[devide]") {
+  std::vector<std::int32_t> a(40, 7);
+  std::vector<std::int32_t> b(40, 1);
+  b[33] = 0;
+  std::vector<std::int32_t> out(40, -1);
+  REQUIRE_THROWS_AS(divide_batch(a, b, out), std::invalid_argument);
+  REQUIRE(out == std::vector<std::int32_t>(40, -1));
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <basics/numbers.h>
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace mse;
+
+namespace {
+const std::int32_t min_int = std::numeric_limits<std::int32_t>::min();
+const std::int32_t max_int = std::numeric_limits<std::int32_t>::max();
+
+std::vector<std::int32_t> edge_values() {
+  std::vector<std::int32_t> values = {min_int, min_int + 1, max_int - 1,
+                                      max_int, 0};
+  for (std::int32_t x = 1; x < 1000; x++) {
+    values.push_back(x);
+    values.push_back(-x);
+  }
+  for (int bit = 10; bit < 31; bit++) {
+    for (std::int32_t delta : {-1, 0, 1}) {
+      values.push_back((1 << bit) + delta);
+      values.push_back(-(1 << bit) - delta);
+    }
+  }
+  std::uint32_t state = 12345;
+  for (int i = 0; i < 2000; i++) {
+    state = state * 1664525u + 1013904223u;
+    values.push_back(static_cast<std::int32_t>(state));
+  }
+  return values;
+}
+} // namespace
+
+TEST_CASE("divider_zero", "[divider]") {
+  REQUIRE_THROWS_AS(divider(0), std::invalid_argument);
+}
+
+TEST_CASE("divider_divisor", "[divider]") {
+  REQUIRE(divider(-7).divisor() == -7);
+}
+
+TEST_CASE("divider_min_-1", "[divider]") {
+  REQUIRE(divider(-1)(min_int) == max_int);
+}
+
+TEST_CASE("divider_min_min", "[divider]") {
+  REQUIRE(divider(min_int)(min_int) == 1);
+}
+
+TEST_CASE("divider_matches_divide", "[divider]") {
+  const std::vector<std::int32_t> values = edge_values();
+  std::vector<std::int32_t> divisors;
+  for (std::int32_t x = 1; x <= 300; x++) {
+    divisors.push_back(x);
+    divisors.push_back(-x);
+  }
+  for (int bit = 9; bit < 31; bit++) {
+    for (std::int32_t delta : {-1, 0, 1}) {
+      divisors.push_back((1 << bit) + delta);
+      divisors.push_back(-(1 << bit) - delta);
+    }
+  }
+  divisors.push_back(min_int);
+  divisors.push_back(max_int);
+  divisors.push_back(123456789);
+  divisors.push_back(-987654321);
+
+  std::vector<std::int32_t> out(values.size());
+  for (auto d : divisors) {
+    const divider div(d);
+    div(values, out);
+    for (std::size_t i = 0; i < values.size(); i++) {
+      const std::int32_t expected = divide(values[i], d);
+      REQUIRE(div(values[i]) == expected);
+      REQUIRE(out[i] == expected);
+    }
+  }
+}
+
+TEST_CASE("divider_size_mismatch", "[divider]") {
+  std::vector<std::int32_t> a = {1, 2, 3};
+  std::vector<std::int32_t> out(2);
+  REQUIRE_THROWS_AS(divider(3)(a, out), std::invalid_argument);
+}
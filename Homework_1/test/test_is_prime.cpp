@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <basics/numbers.h>
+
+using namespace mse;
+
+TEST_CASE("is_prime_small", "[is_prime]") {
+  REQUIRE(!is_prime(0));
+  REQUIRE(!is_prime(1));
+  REQUIRE(is_prime(2));
+  REQUIRE(is_prime(3));
+  REQUIRE(!is_prime(4));
+  REQUIRE(is_prime(53));
+  REQUIRE(!is_prime(59 * 59));
+  REQUIRE(is_prime(3469));
+}
+
+TEST_CASE("is_prime_matches_sieve", "[is_prime]") {
+  const std::uint32_t bound = 1000000;
+  const prime_table table(bound + 1);
+  for (std::uint32_t n = 0; n <= bound; n++) {
+    const bool sieved = table.count_primes(n + 1) != table.count_primes(n);
+    REQUIRE(is_prime(n) == sieved);
+  }
+}
+
+TEST_CASE("is_prime_pseudoprimes", "[is_prime]") {
+  // Carmichael numbers and strong pseudoprimes to small prime bases.
+  for (std::uint64_t n :
+       {561ull, 1105ull, 2047ull, 1373653ull, 25326001ull, 3215031751ull,
+        2152302898747ull, 3474749660383ull, 341550071728321ull,
+        3825123056546413051ull}) {
+    REQUIRE(!is_prime(n));
+  }
+}
+
+TEST_CASE("is_prime_large", "[is_prime]") {
+  REQUIRE(is_prime(2147483647ull));
+  REQUIRE(is_prime(4294967291ull));
+  REQUIRE(!is_prime(4292870399ull)); // 65519 * 65521
+  REQUIRE(is_prime(4294967311ull));
+  REQUIRE(is_prime(2305843009213693951ull)); // 2^61 - 1
+  REQUIRE(is_prime(18446744073709551557ull)); // 2^64 - 59
+  REQUIRE(!is_prime(18446743979220271189ull)); // 4294967279 * 4294967291
+  REQUIRE(!is_prime(18446744073709551615ull));
+}
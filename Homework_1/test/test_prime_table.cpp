@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <basics/numbers.h>
+
+#include <stdexcept>
+
+using namespace mse;
+
+TEST_CASE("prime_table_empty", "[prime_table]") {
+  const prime_table table(0);
+  REQUIRE(table.bound() == 0);
+  REQUIRE(table.count_primes(0) == 0);
+}
+
+TEST_CASE("prime_table_small_bounds", "[prime_table]") {
+  for (std::uint32_t bound = 0; bound < 200; bound++) {
+    const prime_table table(bound);
+    for (std::uint32_t limit = 0; limit <= bound; limit++) {
+      REQUIRE(table.count_primes(limit) == count_primes(limit));
+    }
+  }
+}
+
+TEST_CASE("prime_table_matches_count_primes", "[prime_table]") {
+  const prime_table table(1000000);
+  for (std::uint32_t limit :
+       {0u, 1u, 3u, 4u, 7u, 12u, 123u, 1234u, 4321u, 54321u, 65536u, 999983u,
+        999984u, 1000000u}) {
+    REQUIRE(table.count_primes(limit) == count_primes(limit));
+  }
+}
+
+TEST_CASE("prime_table_block_boundaries", "[prime_table]") {
+  // A 512-bit block holds 64 wheel bytes, the numbers below 1920.
+  const prime_table table(1 << 16);
+  for (std::uint32_t block_end : {1920u, 3840u, 61440u}) {
+    for (std::uint32_t limit = block_end - 40; limit <= block_end + 40; limit++)
+      REQUIRE(table.count_primes(limit) == count_primes(limit));
+  }
+}
+
+TEST_CASE("prime_table_limit_above_bound", "[prime_table]") {
+  const prime_table table(100);
+  REQUIRE_THROWS_AS(table.count_primes(101), std::out_of_range);
+}
+
+TEST_CASE("count_primes_batch_empty", "[prime_table]") {
+  REQUIRE(count_primes_batch({}).empty());
+}
+
+TEST_CASE("count_primes_batch_unordered", "[prime_table]") {
+  const std::vector<std::uint32_t> limits = {54321, 0, 12, 4321, 3, 1234, 123};
+  const std::vector<std::size_t> expected = {5525, 0, 5, 590, 1, 202, 30};
+  REQUIRE(count_primes_batch(limits) == expected);
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <basics/numbers.h>
+#include <basics/roman_codec.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace mse;
+
+TEST_CASE("integer_to_roman_zero", "[roman_codec]") {
+  REQUIRE(integer_to_roman(0).empty());
+}
+
+TEST_CASE("integer_to_roman_examples", "[roman_codec]") {
+  REQUIRE(integer_to_roman(4) == "IV");
+  REQUIRE(integer_to_roman(1994) == "MCMXCIV");
+  REQUIRE(integer_to_roman(3888) == "MMMDCCCLXXXVIII");
+  REQUIRE(integer_to_roman(3999) == "MMMCMXCIX");
+}
+
+TEST_CASE("integer_to_roman_round_trip", "[roman_codec]") {
+  for (std::int32_t number = 0; number < 4000; number++) {
+    REQUIRE(roman_to_integer(integer_to_roman(number)) == number);
+  }
+}
+
+TEST_CASE("integer_to_roman_out_of_range", "[roman_codec]") {
+  REQUIRE_THROWS_AS(integer_to_roman(-1), std::out_of_range);
+  REQUIRE_THROWS_AS(integer_to_roman(4000), std::out_of_range);
+}
+
+TEST_CASE("count_records", "[roman_codec]") {
+  REQUIRE(count_records("") == 0);
+  REQUIRE(count_records("I") == 1);
+  REQUIRE(count_records("I\n") == 1);
+  REQUIRE(count_records("I\nII") == 2);
+  REQUIRE(count_records("\n\n") == 2);
+}
+
+TEST_CASE("roman_to_integer_bulk_small", "[roman_codec]") {
+  const std::string text = "XIV\r\n\nIIII\nMMXXIV";
+  std::vector<std::int32_t> out(count_records(text));
+  const auto malformed = roman_to_integer_bulk(text, out, 4);
+  REQUIRE(malformed == 1);
+  REQUIRE(out == std::vector<std::int32_t>{14, 0, -1, 2024});
+}
+
+TEST_CASE("roman_to_integer_bulk_size_mismatch", "[roman_codec]") {
+  std::vector<std::int32_t> out(1);
+  REQUIRE_THROWS_AS(roman_to_integer_bulk("I\nII\n", out, 1),
+                    std::invalid_argument);
+}
+
+TEST_CASE("roman_to_integer_bulk_threads", "[roman_codec]") {
+  std::vector<std::int32_t> values;
+  for (std::int32_t i = 0; i < 200000; i++)
+    values.push_back(1 + (i * 7919) % 3999);
+  const std::string text = integer_to_roman_bulk(values);
+
+  for (unsigned threads : {1u, 2u, 3u, 8u, 64u}) {
+    std::vector<std::int32_t> out(count_records(text));
+    REQUIRE(roman_to_integer_bulk(text, out, threads) == 0);
+    REQUIRE(out == values);
+  }
+}
+
+TEST_CASE("mapped_file_round_trip", "[roman_codec]") {
+  const auto path =
+      std::filesystem::temp_directory_path() / "mse_roman_codec_test.txt";
+  const std::vector<std::int32_t> values = {1, 3999, 42, 0, 1666};
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << integer_to_roman_bulk(values);
+  }
+
+  {
+    const mapped_file file(path.string());
+    std::vector<std::int32_t> out(count_records(file.view()));
+    REQUIRE(roman_to_integer_bulk(file.view(), out, 2) == 0);
+    REQUIRE(out == values);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped_file_missing", "[roman_codec]") {
+  REQUIRE_THROWS_AS(mapped_file("/nonexistent/mse_roman.txt"),
+                    std::system_error);
+}
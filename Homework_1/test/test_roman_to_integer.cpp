@@ -2,6 +2,9 @@
 
 #include <basics/numbers.h>
 
+#include <stdexcept>
+#include <string>
+
 using namespace mse;
 
 TEST_CASE("roman_to_int_empty", "[roman_to_int]") {
@@ -113,3 +116,39 @@ TEST_CASE("roman_to_int_CM", "[roman_to_int]") {
   const auto res = roman_to_integer("CM");
   REQUIRE(res == 900);
 }
+
+TEST_CASE("roman_to_int_MMMCMXCIX", "[roman_to_int]") {
+  const auto res = roman_to_integer("MMMCMXCIX");
+  REQUIRE(res == 3999);
+}
+
+TEST_CASE("roman_to_int_XXXIX", "[roman_to_int]") {
+  const auto res = roman_to_integer("XXXIX");
+  REQUIRE(res == 39);
+}
+
+TEST_CASE("roman_to_int_string_view", "[roman_to_int]") {
+  const std::string line = "MCMXCIV\n";
+  const auto res = roman_to_integer(std::string_view(line).substr(0, 7));
+  REQUIRE(res == 1994);
+}
+
+TEST_CASE("roman_to_int_error_code_ok", "[roman_to_int]") {
+  std::error_code ec = std::make_error_code(std::errc::invalid_argument);
+  const auto res = roman_to_integer("CIV", ec);
+  REQUIRE(!ec);
+  REQUIRE(res == 104);
+}
+
+TEST_CASE("roman_to_int_malformed", "[roman_to_int]") {
+  for (const char *number :
+       {"IIII", "VV", "VX", "IL", "IC", "XM", "IIV", "VIV", "IXI", "CMC",
+        "DCD", "XCX", "MMMM", "LL", "DD", "IVI", "XIIII", "A", "MCMXCIV ",
+        "mcm", "IXX"}) {
+    std::error_code ec;
+    const auto res = roman_to_integer(number, ec);
+    REQUIRE(ec == std::errc::invalid_argument);
+    REQUIRE(res == 0);
+    REQUIRE_THROWS_AS(roman_to_integer(number), std::invalid_argument);
+  }
+}
@@ -2,6 +2,11 @@
 
 #include <basics/numbers.h>
 
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 using namespace mse;
 
 TEST_CASE("sum_digits_zero", "[sum_digits]") { REQUIRE(sum_digits(0) == 0); }
@@ -45,3 +50,42 @@ TEST_CASE("sum_digits_repeats", "[sum_digits]") {
 TEST_CASE("sum_digits_zeros", "[sum_digits]") {
   REQUIRE(sum_digits(0000) == 0);
 }
+
+TEST_CASE("sum_digits_max", "[sum_digits]") {
+  REQUIRE(sum_digits(std::numeric_limits<std::int32_t>::max()) == 46);
+}
+
+TEST_CASE("sum_digits_min", "[sum_digits]") {
+  REQUIRE(sum_digits(std::numeric_limits<std::int32_t>::min()) == 47);
+}
+
+TEST_CASE("sum_digits_batch_matches_sum_digits", "[sum_digits]") {
+  std::vector<std::int32_t> input = {
+      0,       1,      -1,     9,      10,        99999,     100000,
+      -12005,  999999, 1000000, 99999999, 100000000, 999999999,
+      std::numeric_limits<std::int32_t>::min(),
+      std::numeric_limits<std::int32_t>::max()};
+  std::uint32_t state = 42;
+  for (int i = 0; i < 1000; i++) {
+    state = state * 1664525u + 1013904223u;
+    input.push_back(static_cast<std::int32_t>(state));
+  }
+
+  std::vector<std::size_t> out(input.size());
+  sum_digits_batch(input, out);
+  for (std::size_t i = 0; i < input.size(); i++) {
+    std::size_t expected = 0;
+    for (char c : std::to_string(input[i])) {
+      if (c != '-')
+        expected += c - '0';
+    }
+    REQUIRE(out[i] == expected);
+    REQUIRE(sum_digits(input[i]) == expected);
+  }
+}
+
+TEST_CASE("sum_digits_batch_size_mismatch", "[sum_digits]") {
+  std::vector<std::int32_t> input = {1, 2};
+  std::vector<std::size_t> out(1);
+  REQUIRE_THROWS_AS(sum_digits_batch(input, out), std::invalid_argument);
+}
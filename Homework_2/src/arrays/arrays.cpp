@@ -1,130 +1,623 @@
 #include "arrays.h"
+#include "avx2_kernels.h"
+#include "parallel.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <random>
+#include <utility>
 
 namespace mse {
-int32_t partition(std::vector<std::int32_t> &elements, int32_t start, int32_t end) {
-  int32_t pivot = elements[start];
+namespace {
+// Ranges this short are sorted by a sorting network when AVX2 is available.
+constexpr std::size_t sorting_network_size = 16;
+
+// Misplaced elements between the first scans of partition from this many on
+// are partitioned with AVX2 when it is available.
+constexpr std::size_t simd_partition_threshold = 64;
+
+// int32 in ascending order, with the AVX2 kernels plugged in.
+class int32_sequence
+    : public detail::pointer_sequence<std::int32_t, std::less<>> {
+public:
+  explicit int32_sequence(std::int32_t *data)
+      : pointer_sequence(data, {}), data_(data) {}
+
+  std::optional<std::size_t> partition_block(std::size_t left,
+                                             std::size_t right,
+                                             std::int32_t pivot) {
+    if (right - left < simd_partition_threshold || !avx2::supported())
+      return std::nullopt;
+    return static_cast<std::size_t>(
+        avx2::partition(data_ + left, data_ + right, pivot) - data_);
+  }
 
-  int32_t count = 0;
-  for (int32_t i = start + 1; i <= end; i++) {
-    if (elements[i] <= pivot)
-      count++;
+  bool small_sort(std::size_t begin, std::size_t end) {
+    if (end - begin > sorting_network_size || !avx2::supported())
+      return false;
+    avx2::sort16(data_ + begin, end - begin);
+    return true;
   }
 
-  int32_t pivotIndex = start + count;
-  std::swap(elements[pivotIndex], elements[start]);
+private:
+  std::int32_t *data_;
+};
+
+// From this size on mse::sort is a radix sort: it does a fixed number of
+// passes regardless of n, which pays for its scratch buffer and for clearing
+// and scanning 3 x 2048 counters. With the AVX2 introsort below it, radix
+// sort starts to win somewhere between 512 and 2048 elements depending on
+// the machine, so the switch is made well past that.
+constexpr std::size_t radix_sort_threshold = std::size_t(1) << 12;
+
+// LSD radix sort digits: three passes of 11, 11 and 10 bits.
+constexpr int radix_bits = 11;
+constexpr int radix_passes = 3;
+constexpr std::size_t radix_size = std::size_t(1) << radix_bits;
+
+// Flipping the sign bit orders int32 values as unsigned keys.
+std::uint32_t radix_key(std::int32_t value) {
+  return static_cast<std::uint32_t>(value) ^ 0x80000000u;
+}
 
-  int32_t i = start, j = end;
-  while (i < pivotIndex && j > pivotIndex) {
-    while (elements[i] <= pivot)
-      i++;
+std::size_t radix_digit(std::int32_t value, int pass) {
+  return (radix_key(value) >> (pass * radix_bits)) & (radix_size - 1);
+}
 
-    while (elements[j] > pivot)
-      j--;
+// Sorts [first, first + size), ping-ponging with scratch, which must hold as
+// many elements.
+void radix_sort(std::int32_t *first, std::int32_t *scratch,
+                std::size_t size) {
+  // Histograms of all digits, gathered in a single pass.
+  std::array<std::array<std::size_t, radix_size>, radix_passes> counts{};
+  for (std::size_t i = 0; i < size; i++) {
+    const std::uint32_t key = radix_key(first[i]);
+    counts[0][key & (radix_size - 1)]++;
+    counts[1][(key >> radix_bits) & (radix_size - 1)]++;
+    counts[2][key >> (2 * radix_bits)]++;
+  }
 
-    if (i < pivotIndex && j > pivotIndex)
-      std::swap(elements[i++], elements[j--]);
+  std::int32_t *from = first;
+  std::int32_t *to = scratch;
+  for (int pass = 0; pass < radix_passes; pass++) {
+    auto &offsets = counts[pass];
+    // Every element has the same digit: the pass would not move anything.
+    if (offsets[radix_digit(from[0], pass)] == size)
+      continue;
+
+    std::size_t offset = 0;
+    for (auto &count : offsets)
+      offset += std::exchange(count, offset);
+    for (std::size_t i = 0; i < size; i++)
+      to[offsets[radix_digit(from[i], pass)]++] = from[i];
+    std::swap(from, to);
   }
-  return pivotIndex;
+
+  if (from != first)
+    std::copy(from, from + size, first);
 }
 
+// Sequential sort of [first, last). scratch must be as large as the range, or
+// null to have it allocated when needed.
+void sort_range(std::int32_t *first, std::int32_t *last,
+                std::int32_t *scratch) {
+  const auto size = static_cast<std::size_t>(last - first);
+  if (size < radix_sort_threshold) {
+    int32_sequence sequence(first);
+    detail::sort(sequence, size);
+    return;
+  }
 
-void quick_sort(std::vector<std::int32_t> &arr, int32_t start, int32_t end) {
-  if (start >= end)
+  // Unlike introsort, radix sort gains nothing from sorted input.
+  if (std::is_sorted(first, last))
     return;
 
-  int32_t p = partition(arr, start, end);
+  std::vector<std::int32_t> buffer;
+  if (scratch == nullptr) {
+    buffer.resize(size);
+    scratch = buffer.data();
+  }
+  radix_sort(first, scratch, size);
+}
+
+// Below this size per thread, threads cost more than they save.
+constexpr std::size_t parallel_sort_threshold = std::size_t(1) << 17;
+
+// Buckets per thread: with more buckets than threads, a thread that drew
+// small buckets picks up more of them, which evens out the load.
+constexpr std::size_t buckets_per_thread = 8;
+
+// Sample elements per bucket, from which the splitters are picked.
+constexpr std::size_t oversampling = 32;
+
+// Sample sort splitters, stored as an implicit binary search tree so that
+// finding the bucket of a value takes log2(buckets) steps without branches.
+class splitter_tree {
+public:
+  // buckets must be a power of two. The splitters are the buckets - 1 values
+  // cutting a sorted random sample of the elements into equal parts.
+  splitter_tree(const std::vector<std::int32_t> &elements, std::size_t buckets)
+      : levels_(std::countr_zero(buckets)), tree_(buckets) {
+    std::mt19937_64 generator(elements.size());
+    std::uniform_int_distribution<std::size_t> index(0, elements.size() - 1);
+    std::vector<std::int32_t> sample(buckets * oversampling);
+    for (auto &value : sample)
+      value = elements[index(generator)];
+    sort_range(sample.data(), sample.data() + sample.size(), nullptr);
+
+    std::vector<std::int32_t> splitters(buckets - 1);
+    for (std::size_t b = 1; b < buckets; b++)
+      splitters[b - 1] = sample[b * oversampling];
+    build(splitters, 1, 0, splitters.size());
+  }
 
-  quick_sort(arr, start, p - 1);
-  quick_sort(arr, p + 1, end);
+  // The number of splitters not greater than value.
+  [[nodiscard]] std::size_t bucket(std::int32_t value) const {
+    std::size_t node = 1;
+    for (int level = 0; level < levels_; level++)
+      node = 2 * node + std::size_t(tree_[node] <= value);
+    return node - tree_.size();
+  }
+
+private:
+  // Node k has children 2k and 2k + 1; the root is node 1.
+  void build(const std::vector<std::int32_t> &splitters, std::size_t node,
+             std::size_t begin, std::size_t end) {
+    if (begin == end)
+      return;
+    const std::size_t middle = begin + (end - begin) / 2;
+    tree_[node] = splitters[middle];
+    build(splitters, 2 * node, begin, middle);
+    build(splitters, 2 * node + 1, middle + 1, end);
+  }
+
+  int levels_;
+  std::vector<std::int32_t> tree_;
+};
+
+// Sample sort. Each thread classifies a contiguous chunk of the input by the
+// splitters, then scatters it into a buffer in which every bucket is
+// contiguous. The buckets are sorted independently, each thread taking the
+// next unsorted one until none are left, and copied back.
+void parallel_sort(std::vector<std::int32_t> &elements, std::size_t threads) {
+  const std::size_t size = elements.size();
+  const std::size_t buckets = std::bit_ceil(threads * buckets_per_thread);
+  const splitter_tree splitters(elements, buckets);
+  auto chunk_begin = [&](std::size_t k) { return k * (size / threads); };
+  auto chunk_end = [&](std::size_t k) {
+    return k + 1 == threads ? size : chunk_begin(k + 1);
+  };
+
+  // offsets[k][b]: counts, and then the position of the next element of
+  // bucket b from chunk k.
+  std::vector<std::vector<std::size_t>> offsets(
+      threads, std::vector<std::size_t>(buckets, 0));
+  detail::run_parallel(threads, [&](std::size_t k) {
+    for (std::size_t i = chunk_begin(k); i < chunk_end(k); i++)
+      offsets[k][splitters.bucket(elements[i])]++;
+  });
+
+  std::vector<std::size_t> bucket_begin(buckets + 1, size);
+  std::size_t offset = 0;
+  for (std::size_t b = 0; b < buckets; b++) {
+    bucket_begin[b] = offset;
+    for (std::size_t k = 0; k < threads; k++)
+      offset += std::exchange(offsets[k][b], offset);
+  }
+
+  std::vector<std::int32_t> buffer(size);
+  detail::run_parallel(threads, [&](std::size_t k) {
+    for (std::size_t i = chunk_begin(k); i < chunk_end(k); i++)
+      buffer[offsets[k][splitters.bucket(elements[i])]++] = elements[i];
+  });
+
+  std::atomic<std::size_t> next_bucket = 0;
+  detail::run_parallel(threads, [&](std::size_t) {
+    for (std::size_t b = next_bucket++; b < buckets; b = next_bucket++) {
+      std::int32_t *first = buffer.data() + bucket_begin[b];
+      std::int32_t *last = buffer.data() + bucket_begin[b + 1];
+      std::int32_t *target = elements.data() + bucket_begin[b];
+      // This bucket's part of elements is free by now and serves as scratch.
+      sort_range(first, last, target);
+      std::copy(first, last, target);
+    }
+  });
 }
+} // namespace
 
+void detail::sort_int32(std::int32_t *data, std::size_t size) {
+  sort_range(data, data + size, nullptr);
+}
+
+void detail::select_int32(std::int32_t *data, std::size_t size,
+                          std::size_t nth) {
+  int32_sequence sequence(data);
+  detail::select(sequence, size, nth);
+}
 
 void sort(std::vector<std::int32_t> &elements) {
-  quick_sort(elements, 0, elements.size() - 1);
+  sort_range(elements.data(), elements.data() + elements.size(), nullptr);
 }
 
+void sort(std::vector<std::int32_t> &elements, parallel_policy policy) {
+  const std::size_t threads =
+      detail::thread_count(policy, elements.size(), parallel_sort_threshold);
+  if (threads == 1 || std::is_sorted(elements.begin(), elements.end())) {
+    sort(elements);
+    return;
+  }
+  parallel_sort(elements, threads);
+}
+
+
+namespace {
+// trace and find_max_square read the matrix through row(i), a pointer to the
+// first element of row i, so that views and vectors of rows share the code.
+template <typename Row> std::int64_t diagonal_sum(Row row, std::size_t size) {
+  std::int64_t sum = 0;
+  for (std::size_t i = 0; i < size; i++)
+    sum += row(i)[i];
+  return sum;
+}
+} // namespace
+
+std::int64_t trace(matrix_view<const std::int32_t> matrix) {
+  return diagonal_sum([&](std::size_t i) { return matrix.row(i).data(); },
+                      std::min(matrix.rows(), matrix.cols()));
+}
 
 std::int32_t trace(const std::vector<std::vector<std::int32_t>> &matrix) {
-  int32_t n = matrix.size();
-  int32_t trace = 0;
+  const std::size_t size =
+      matrix.empty() ? 0 : std::min(matrix.size(), matrix[0].size());
+  const std::int64_t sum =
+      diagonal_sum([&](std::size_t i) { return matrix[i].data(); }, size);
+  if (sum < std::numeric_limits<std::int32_t>::min() ||
+      sum > std::numeric_limits<std::int32_t>::max())
+    throw std::overflow_error("trace: the sum does not fit in int32.");
+  return static_cast<std::int32_t>(sum);
+}
+
+
+namespace {
+// Open-addressing hash table counting occurrences of int32 keys. Counts stop
+// at 2, which is all find_unique_element needs to know.
+class flat_counter {
+public:
+  flat_counter() = default;
+
+  // Room for max_keys distinct keys at a load factor of at most 1/2.
+  explicit flat_counter(std::size_t max_keys)
+      : bits_(std::bit_width(std::max<std::size_t>(2 * max_keys, 16) - 1)),
+        slots_(std::size_t(1) << bits_) {}
+
+  void add(std::int32_t key) {
+    slot &entry = slots_[find(key)];
+    entry.key = key;
+    entry.count = std::min(entry.count + 1, 2u);
+  }
 
-  for (int32_t i = 0; i < n; i++)
-    trace += matrix[i][i];
+  [[nodiscard]] std::uint32_t count(std::int32_t key) const {
+    return slots_[find(key)].count;
+  }
+
+private:
+  // Key and count side by side, so that a lookup touches one cache line.
+  struct slot {
+    std::int32_t key = 0;
+    // 0 marks an empty slot.
+    std::uint32_t count = 0;
+  };
+
+  // The slot holding key, or the empty one where it would go. Slots are
+  // probed linearly from a multiplicative hash.
+  std::size_t find(std::int32_t key) const {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t index = static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key)) *
+         0x9E3779B97F4A7C15ull) >>
+        (64 - bits_));
+    while (slots_[index].count != 0 && slots_[index].key != key)
+      index = (index + 1) & mask;
+    return index;
+  }
+
+  int bits_ = 0;
+  std::vector<slot> slots_;
+};
+
+// Below this size per thread, threads cost more than they save.
+constexpr std::size_t parallel_count_threshold = std::size_t(1) << 16;
 
-  return trace;
+// Which of parts hash partitions key belongs to. The hash differs from the
+// one of flat_counter, so that keys of one partition still spread over the
+// whole table.
+std::size_t hash_partition(std::int32_t key, std::size_t parts) {
+  const std::uint32_t hash = static_cast<std::uint32_t>(key) * 0x85EBCA6Bu;
+  return static_cast<std::size_t>((std::uint64_t(hash) * parts) >> 32);
 }
 
+// Counting is split by hash partitions of the keys, so that every thread
+// owns its own flat_counter. The threads first scatter their chunks of the
+// input by partition, then count one partition each, and finally scan their
+// chunks in order for the first key counted once; the earliest chunk with
+// such a key has the answer.
+std::int32_t find_unique_element_parallel(
+    const std::vector<std::int32_t> &elements, std::size_t threads) {
+  const std::size_t size = elements.size();
+  auto chunk_begin = [&](std::size_t k) { return k * (size / threads); };
+  auto chunk_end = [&](std::size_t k) {
+    return k + 1 == threads ? size : chunk_begin(k + 1);
+  };
+
+  // offsets[k][p]: counts, and then the position of the next key of
+  // partition p from chunk k.
+  std::vector<std::vector<std::size_t>> offsets(
+      threads, std::vector<std::size_t>(threads, 0));
+  detail::run_parallel(threads, [&](std::size_t k) {
+    for (std::size_t i = chunk_begin(k); i < chunk_end(k); i++)
+      offsets[k][hash_partition(elements[i], threads)]++;
+  });
+
+  std::vector<std::size_t> partition_begin(threads + 1, size);
+  std::size_t offset = 0;
+  for (std::size_t p = 0; p < threads; p++) {
+    partition_begin[p] = offset;
+    for (std::size_t k = 0; k < threads; k++)
+      offset += std::exchange(offsets[k][p], offset);
+  }
 
-std::int32_t find_unique_element(const std::vector<std::int32_t> &elements) {
-  int32_t n = elements.size();
-
-  for (int32_t i = 0; i < n; i++){
-    int32_t pivot = elements[i];
-    int32_t count_pivot = 0;
-    for (int32_t j = 0; j < n; j++){
-      if (elements[j] == pivot)
-        count_pivot++;
+  std::vector<std::int32_t> buffer(size);
+  detail::run_parallel(threads, [&](std::size_t k) {
+    for (std::size_t i = chunk_begin(k); i < chunk_end(k); i++)
+      buffer[offsets[k][hash_partition(elements[i], threads)]++] = elements[i];
+  });
+
+  std::vector<flat_counter> counters(threads);
+  detail::run_parallel(threads, [&](std::size_t p) {
+    counters[p] = flat_counter(partition_begin[p + 1] - partition_begin[p]);
+    for (std::size_t i = partition_begin[p]; i < partition_begin[p + 1]; i++)
+      counters[p].add(buffer[i]);
+  });
+
+  std::vector<std::size_t> first_unique(threads, size);
+  detail::run_parallel(threads, [&](std::size_t k) {
+    for (std::size_t i = chunk_begin(k); i < chunk_end(k); i++) {
+      const std::int32_t key = elements[i];
+      if (counters[hash_partition(key, threads)].count(key) == 1) {
+        first_unique[k] = i;
+        break;
+      }
     }
-    if (count_pivot == 1)
-      return pivot;
+  });
+
+  for (const std::size_t i : first_unique) {
+    if (i != size)
+      return elements[i];
   }
   return -1;
 }
+} // namespace
 
+std::int32_t find_unique_element(const std::vector<std::int32_t> &elements) {
+  flat_counter counter(elements.size());
+  for (const std::int32_t element : elements)
+    counter.add(element);
 
-std::size_t find_max_square(const std::vector<std::vector<std::int8_t>> &matrix){
-  std::size_t rows = matrix.size();
+  for (const std::int32_t element : elements) {
+    if (counter.count(element) == 1)
+      return element;
+  }
+  return -1;
+}
 
-  if (rows == 0)
-    return 0;
+std::int32_t find_unique_element(const std::vector<std::int32_t> &elements,
+                                 parallel_policy policy) {
+  const std::size_t threads =
+      detail::thread_count(policy, elements.size(), parallel_count_threshold);
+  if (threads == 1)
+    return find_unique_element(elements);
+  return find_unique_element_parallel(elements, threads);
+}
 
-  std::size_t cols = matrix[0].size();
+std::int32_t find_unique_element(const std::vector<std::int32_t> &elements,
+                                 pairs_tag) {
+  // An even number of elements cannot be pairs plus one unique element.
+  if (elements.size() % 2 == 0)
+    return -1;
 
-  std::vector<std::vector<std::uint32_t>> help_matrix(rows, std::vector<std::uint32_t>(cols, 0));
+  std::int32_t result = 0;
+  for (const std::int32_t element : elements)
+    result ^= element;
+  return result;
+}
 
-  for (uint i = 0; i < rows; i++) {
-    for (uint j = 0; j < cols; j++) {
-      if (matrix[i][j] == 1) {
-        if (j >= 1)
-          help_matrix[i][j] = help_matrix[i][j - 1] + 1;
-        else
-          help_matrix[i][j] = 1;
-      }
+
+namespace {
+// side(i, j), the side of the largest square of ones with its bottom-right
+// corner at (i, j), is one more than the least of the sides above, to the
+// left and above-left, or 0 for a zero. Only one row of sides is kept.
+template <typename Row>
+std::size_t max_square(Row row, std::size_t rows, std::size_t cols) {
+  // sides[j + 1] is the side at column j, of the current row up to the column
+  // being computed and of the previous row after it; sides[0] stays 0.
+  std::vector<std::uint32_t> sides(cols + 1, 0);
+  std::uint32_t max_side = 0;
+
+  for (std::size_t i = 0; i < rows; i++) {
+    const auto *values = row(i);
+    std::uint32_t above_left = 0;
+    for (std::size_t j = 0; j < cols; j++) {
+      const std::uint32_t above = sides[j + 1];
+      sides[j + 1] =
+          values[j] == 1 ? std::min({above, sides[j], above_left}) + 1 : 0;
+      above_left = above;
+      max_side = std::max(max_side, sides[j + 1]);
     }
   }
+  return std::size_t{max_side} * max_side;
+}
+} // namespace
 
-  uint max_square = 0;
+std::size_t find_max_square(matrix_view<const std::int8_t> matrix) {
+  return max_square([&](std::size_t i) { return matrix.row(i).data(); },
+                    matrix.rows(), matrix.cols());
+}
 
-  for (uint i = 0; i < rows; i++) {
-    for (uint j = 0; j < cols; j++) {
-      if (help_matrix[i][j] >= 1) {
-        uint count = help_matrix[i][j];
-        bool enough = true;
+std::size_t
+find_max_square(const std::vector<std::vector<std::int8_t>> &matrix) {
+  return max_square([&](std::size_t i) { return matrix[i].data(); },
+                    matrix.size(), matrix.empty() ? 0 : matrix[0].size());
+}
 
-        if (count - 1 > rows - i - 1)
-          break;
+std::size_t packed_row_words(std::size_t cols) { return (cols + 63) / 64; }
 
-        uint max_side = count;
-        for (uint k = 1; k < count; k++){
-          uint pivot = help_matrix[i+k][j];
-          if (pivot < count && pivot == k + 1) {
-            max_side = pivot;
-            break;
-          }
-          else if (pivot < count) {
-            enough = false;
-            break;
-          }
-        }
+namespace {
+// Whether a is larger than b, or as large and first in row-major order.
+bool better_square(const square &a, const square &b) {
+  if (a.side != b.side)
+    return a.side > b.side;
+  return std::pair(a.row, a.col) < std::pair(b.row, b.col);
+}
 
-        uint square = max_side * max_side;
-        if (enough && (square > max_square))
-          max_square = square;
+// Updates sides[0, count), the sides of columns first, ... of the row above,
+// to those of row, whose bits start at words; left is the side just before
+// the segment in this row and above_left the one above it. Records squares
+// better than best, and returns the side at the last column. Tiles of the
+// wavefront are not swept in row-major order, so ties are broken by position
+// rather than by which square was found first.
+std::uint32_t update_packed_sides(const std::uint64_t *words, std::size_t row,
+                                  std::size_t first, std::size_t count,
+                                  std::uint32_t *sides, std::uint32_t left,
+                                  std::uint32_t above_left, square &best) {
+  for (std::size_t k = 0; k < count;) {
+    const std::size_t column = first + k;
+    const std::uint64_t bits = words[column / 64] >> (column % 64);
+    const std::size_t run = std::min(64 - column % 64, count - k);
+
+    // A run of zeros is common in sparse grids and only clears the sides.
+    if (bits == 0) {
+      above_left = sides[k + run - 1];
+      std::fill(sides + k, sides + k + run, 0u);
+      left = 0;
+      k += run;
+      continue;
+    }
 
+    for (std::size_t b = 0; b < run; b++, k++) {
+      const std::uint32_t above = sides[k];
+      left = (bits >> b) & 1 ? std::min({above, left, above_left}) + 1 : 0;
+      sides[k] = left;
+      above_left = above;
+      if (left != 0 && left >= best.side) {
+        const square found{left, row + 1 - left, first + k + 1 - left};
+        if (better_square(found, best))
+          best = found;
       }
     }
   }
-  return max_square;
+  return left;
+}
+
+// Below this many cells per thread, threads cost more than they save.
+constexpr std::size_t parallel_square_threshold = std::size_t(1) << 22;
+
+// Tiles span this many rows, and at least min_tile_cols columns.
+constexpr std::size_t tile_rows = 256;
+constexpr std::size_t min_tile_cols = 1024;
+
+// Tile columns per thread, so that most wavefronts keep every thread busy.
+constexpr std::size_t tile_cols_per_thread = 4;
+
+// A tile depends on the tiles above, to the left and above-left of it, so all
+// tiles of an anti-diagonal are independent once the previous ones are done.
+// Between tiles the sides flow through bottom, the last row of sides of each
+// column, right, the last column of sides of each row, and corner, the side
+// above-left of the next tile of each tile row.
+square find_max_square_wavefront(matrix_view<const std::uint64_t> words,
+                                 std::size_t cols, std::size_t threads) {
+  const std::size_t rows = words.rows();
+  const std::size_t tile_col_count = threads * tile_cols_per_thread;
+  const std::size_t tile_cols = std::max(
+      min_tile_cols,
+      packed_row_words((cols + tile_col_count - 1) / tile_col_count) * 64);
+  const std::size_t row_tiles = (rows + tile_rows - 1) / tile_rows;
+  const std::size_t col_tiles = (cols + tile_cols - 1) / tile_cols;
+
+  std::vector<std::uint32_t> bottom(cols, 0);
+  std::vector<std::uint32_t> right(rows, 0);
+  std::vector<std::uint32_t> corner(row_tiles, 0);
+  std::vector<square> best(threads);
+
+  auto sweep_tile = [&](std::size_t ti, std::size_t tj, square &tile_best) {
+    const std::size_t row_end = std::min(rows, (ti + 1) * tile_rows);
+    const std::size_t first = tj * tile_cols;
+    const std::size_t count = std::min(tile_cols, cols - first);
+    std::uint32_t *sides = bottom.data() + first;
+
+    std::uint32_t above_left = corner[ti];
+    corner[ti] = sides[count - 1];
+    for (std::size_t i = ti * tile_rows; i < row_end; i++) {
+      const std::uint32_t left = right[i];
+      right[i] = update_packed_sides(words.row(i).data(), i, first, count,
+                                     sides, left, above_left, tile_best);
+      above_left = left;
+    }
+  };
+
+  std::barrier wavefront_done(static_cast<std::ptrdiff_t>(threads));
+  detail::run_parallel(threads, [&](std::size_t k) {
+    for (std::size_t wave = 0; wave + 1 < row_tiles + col_tiles; wave++) {
+      const std::size_t first_ti = wave < col_tiles ? 0 : wave - col_tiles + 1;
+      const std::size_t last_ti = std::min(wave, row_tiles - 1);
+      for (std::size_t ti = first_ti + k; ti <= last_ti; ti += threads)
+        sweep_tile(ti, wave - ti, best[k]);
+      wavefront_done.arrive_and_wait();
+    }
+  });
+
+  return *std::min_element(best.begin(), best.end(), better_square);
+}
+} // namespace
+
+max_square_stream::max_square_stream(std::size_t cols)
+    : cols_(cols), sides_(cols, 0) {}
+
+void max_square_stream::push_row(std::span<const std::uint64_t> row) {
+  if (row.size() != packed_row_words(cols_))
+    throw std::invalid_argument(
+        "max_square_stream: row must have packed_row_words(cols) words.");
+  update_packed_sides(row.data(), rows_++, 0, cols_, sides_.data(), 0, 0,
+                      best_);
+}
+
+square max_square_stream::result() const { return best_; }
+
+square find_max_square_packed(matrix_view<const std::uint64_t> words,
+                              std::size_t cols) {
+  return find_max_square_packed(words, cols, parallel_policy{1});
+}
+
+square find_max_square_packed(matrix_view<const std::uint64_t> words,
+                              std::size_t cols, parallel_policy policy) {
+  const std::size_t row_words = packed_row_words(cols);
+  if (words.cols() < row_words)
+    throw std::invalid_argument(
+        "find_max_square_packed: rows must have packed_row_words(cols) words.");
+
+  const std::size_t threads = detail::thread_count(
+      policy, words.rows() * cols, parallel_square_threshold);
+  if (threads > 1)
+    return find_max_square_wavefront(words, cols, threads);
+
+  max_square_stream stream(cols);
+  for (std::size_t i = 0; i < words.rows(); i++)
+    stream.push_row(words.row(i).first(row_words));
+  return stream.result();
 }
 
 } // namespace mse
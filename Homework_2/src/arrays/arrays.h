@@ -1,20 +1,276 @@
 #pragma once
 
+#include "introsort.h"
+#include "matrix_view.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <numeric>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace mse {
 
+// Selects the multi-threaded overloads: mse::par uses every hardware thread,
+// mse::parallel_policy{n} at most n of them.
+struct parallel_policy {
+  unsigned threads = 0;
+};
+
+inline constexpr parallel_policy par{};
+
 void sort(std::vector<std::int32_t> &elements);
 
+// Parallel sample sort; small inputs are sorted sequentially.
+void sort(std::vector<std::int32_t> &elements, parallel_policy policy);
+
+// Sorts elements by compare, which must be a strict weak order. The sort is
+// not stable.
+template <typename T, typename Compare = std::less<>>
+void sort(std::span<T> elements, Compare compare = {});
+
+// Sorts keys by compare and applies the same permutation to values, in place.
+// Throws std::invalid_argument if the spans differ in size.
+template <typename K, typename V, typename Compare = std::less<>>
+void sort_by_key(std::span<K> keys, std::span<V> values, Compare compare = {});
+
+// The permutation that sorts elements by compare: element indices in sorted
+// order. Throws std::invalid_argument if there are 2^32 elements or more.
+template <typename T, typename Compare = std::less<>>
+[[nodiscard]] std::vector<std::uint32_t> argsort(std::span<const T> elements,
+                                                 Compare compare = {});
+
+// Rearranges elements so that elements[n] is the element that would be there
+// if they were sorted by compare, with no greater one before it and no smaller
+// one after it. Linear time even on adversarial input. Throws
+// std::out_of_range if n is not less than the size.
+template <typename T, typename Compare = std::less<>>
+void nth_element(std::span<T> elements, std::size_t n, Compare compare = {});
+
+// Sorts the k smallest elements into the front of elements; the order of the
+// others is unspecified. Throws std::out_of_range if k exceeds the size.
+template <typename T, typename Compare = std::less<>>
+void partial_sort(std::span<T> elements, std::size_t k, Compare compare = {});
+
+// The k greatest elements (all of them if there are fewer), greatest first.
+template <typename T, typename Compare = std::less<>>
+[[nodiscard]] std::vector<T> top_k(std::span<const T> elements, std::size_t k,
+                                   Compare compare = {});
+
+// The k greatest elements of a stream that need not fit in memory, kept in a
+// heap of at most k elements: push costs O(log k).
+template <typename T, typename Compare = std::less<>> class top_k_stream {
+public:
+  explicit top_k_stream(std::size_t k, Compare compare = {});
+
+  void push(T value);
+
+  // The k greatest elements pushed so far, greatest first.
+  [[nodiscard]] std::vector<T> result() const;
+
+private:
+  std::size_t k_;
+  // Reversed order, so that the heap top is the least of the elements kept.
+  struct greater {
+    Compare compare;
+    bool operator()(const T &a, const T &b) const { return compare(b, a); }
+  };
+  greater greater_;
+  std::vector<T> heap_;
+};
+
+// The sum of the main diagonal, which has min(rows, cols) elements. Summed in
+// 64 bits, so it does not overflow.
+[[nodiscard]] std::int64_t trace(matrix_view<const std::int32_t> matrix);
+
+// The same sum for a vector of rows. Throws std::overflow_error if it does not
+// fit in int32; the matrix_view overload returns it in full.
 [[nodiscard]] std::int32_t
 trace(const std::vector<std::vector<std::int32_t>> &matrix);
 
+// Tells find_unique_element that every value but one appears exactly twice.
+struct pairs_tag {};
+
+inline constexpr pairs_tag pairs{};
+
+// The first element, in order, that appears only once, or -1 if there is
+// none. Counts in a hash table: O(n) expected time.
 [[nodiscard]] std::int32_t
 find_unique_element(const std::vector<std::int32_t> &elements);
 
+// Same, counting on several threads; small inputs are counted sequentially.
+[[nodiscard]] std::int32_t
+find_unique_element(const std::vector<std::int32_t> &elements,
+                    parallel_policy policy);
+
+// The XOR of all elements, which is the unique one if every other value
+// appears exactly twice; -1 for an even number of elements.
+[[nodiscard]] std::int32_t
+find_unique_element(const std::vector<std::int32_t> &elements, pairs_tag);
+
+// The area of the largest square of ones.
+[[nodiscard]] std::size_t find_max_square(matrix_view<const std::int8_t> matrix);
+
+// Same; the row length is that of the first row.
 [[nodiscard]] std::size_t
 find_max_square(const std::vector<std::vector<std::int8_t>> &matrix);
 
+// A square of ones: its side and the row and column of its top-left corner.
+struct square {
+  std::size_t side = 0;
+  std::size_t row = 0;
+  std::size_t col = 0;
+};
+
+// Words per row of a bit-packed binary matrix with cols columns: column j of
+// a row is bit j % 64 of word j / 64, and the bits past cols are ignored.
+[[nodiscard]] std::size_t packed_row_words(std::size_t cols);
+
+// The largest square of ones in bit-packed rows pushed one at a time, top to
+// bottom. Keeps a single row of sides: O(cols) memory for any number of rows.
+class max_square_stream {
+public:
+  explicit max_square_stream(std::size_t cols);
+
+  // Throws std::invalid_argument if row is not packed_row_words(cols) long.
+  void push_row(std::span<const std::uint64_t> row);
+
+  // The largest square of the rows pushed so far; the first in row-major
+  // order if there are several.
+  [[nodiscard]] square result() const;
+
+private:
+  std::size_t cols_;
+  std::size_t rows_ = 0;
+  std::vector<std::uint32_t> sides_;
+  square best_;
+};
+
+// The largest square of ones, the first in row-major order if there are
+// several, in a bit-packed matrix whose rows are the rows of words. Throws
+// std::invalid_argument if words has fewer than packed_row_words(cols)
+// columns.
+[[nodiscard]] square
+find_max_square_packed(matrix_view<const std::uint64_t> words,
+                       std::size_t cols);
+
+// Same, on several threads, which sweep tiles of the matrix along
+// anti-diagonal wavefronts; small matrices are searched sequentially.
+[[nodiscard]] square
+find_max_square_packed(matrix_view<const std::uint64_t> words,
+                       std::size_t cols, parallel_policy policy);
+
+// Same for a file of bit-packed rows in native byte order, which is mapped
+// into memory. Throws std::system_error if the file cannot be mapped and
+// std::invalid_argument if its size is not a whole number of rows.
+[[nodiscard]] square find_max_square_packed(const std::string &path,
+                                            std::size_t cols);
+
+[[nodiscard]] square find_max_square_packed(const std::string &path,
+                                            std::size_t cols,
+                                            parallel_policy policy);
+
+template <typename T, typename Compare>
+void sort(std::span<T> elements, Compare compare) {
+  if constexpr (detail::is_int32_ascending<T, Compare>) {
+    detail::sort_int32(elements.data(), elements.size());
+  } else {
+    detail::pointer_sequence<T, Compare> sequence(elements.data(),
+                                                  std::move(compare));
+    detail::sort(sequence, elements.size());
+  }
+}
+
+template <typename K, typename V, typename Compare>
+void sort_by_key(std::span<K> keys, std::span<V> values, Compare compare) {
+  if (keys.size() != values.size())
+    throw std::invalid_argument("sort_by_key: spans must have equal sizes.");
+
+  detail::key_value_sequence<K, V, Compare> sequence(
+      keys.data(), values.data(), std::move(compare));
+  detail::sort(sequence, keys.size());
+}
+
+template <typename T, typename Compare>
+std::vector<std::uint32_t> argsort(std::span<const T> elements,
+                                   Compare compare) {
+  if (elements.size() > std::numeric_limits<std::uint32_t>::max())
+    throw std::invalid_argument("argsort: too many elements.");
+
+  std::vector<std::uint32_t> indices(elements.size());
+  std::iota(indices.begin(), indices.end(), 0u);
+  auto by_element = [&](std::uint32_t a, std::uint32_t b) {
+    return compare(elements[a], elements[b]);
+  };
+  detail::pointer_sequence<std::uint32_t, decltype(by_element)> sequence(
+      indices.data(), by_element);
+  detail::sort(sequence, indices.size());
+  return indices;
+}
+
+template <typename T, typename Compare>
+void nth_element(std::span<T> elements, std::size_t n, Compare compare) {
+  if (n >= elements.size())
+    throw std::out_of_range("nth_element: n is out of range.");
+
+  if constexpr (detail::is_int32_ascending<T, Compare>) {
+    detail::select_int32(elements.data(), elements.size(), n);
+  } else {
+    detail::pointer_sequence<T, Compare> sequence(elements.data(),
+                                                  std::move(compare));
+    detail::select(sequence, elements.size(), n);
+  }
+}
+
+template <typename T, typename Compare>
+void partial_sort(std::span<T> elements, std::size_t k, Compare compare) {
+  if (k > elements.size())
+    throw std::out_of_range("partial_sort: k is out of range.");
+
+  if (k < elements.size())
+    nth_element(elements, k, compare);
+  sort(elements.first(k), std::move(compare));
+}
+
+template <typename T, typename Compare>
+std::vector<T> top_k(std::span<const T> elements, std::size_t k,
+                     Compare compare) {
+  std::vector<T> result(elements.begin(), elements.end());
+  k = std::min(k, result.size());
+  partial_sort(std::span<T>(result), k,
+               [&](const T &a, const T &b) { return compare(b, a); });
+  result.resize(k);
+  return result;
+}
+
+template <typename T, typename Compare>
+top_k_stream<T, Compare>::top_k_stream(std::size_t k, Compare compare)
+    : k_(k), greater_{std::move(compare)} {
+  heap_.reserve(k);
+}
+
+template <typename T, typename Compare>
+void top_k_stream<T, Compare>::push(T value) {
+  if (heap_.size() < k_) {
+    heap_.push_back(std::move(value));
+    std::push_heap(heap_.begin(), heap_.end(), greater_);
+  } else if (k_ != 0 && greater_.compare(heap_.front(), value)) {
+    std::pop_heap(heap_.begin(), heap_.end(), greater_);
+    heap_.back() = std::move(value);
+    std::push_heap(heap_.begin(), heap_.end(), greater_);
+  }
+}
+
+template <typename T, typename Compare>
+std::vector<T> top_k_stream<T, Compare>::result() const {
+  std::vector<T> result = heap_;
+  std::sort_heap(result.begin(), result.end(), greater_);
+  return result;
+}
+
 } // namespace mse
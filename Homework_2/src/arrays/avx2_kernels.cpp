@@ -0,0 +1,188 @@
+#include "avx2_kernels.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace mse::avx2 {
+#if defined(__x86_64__) || defined(__i386__)
+namespace {
+// For every mask of 8 lanes, a lane order that puts the lanes in the mask
+// first and the others after them, packed as 4 bits per position.
+constexpr std::array<std::uint32_t, 256> compress_table = [] {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t mask = 0; mask < table.size(); mask++) {
+    std::uint32_t position = 0;
+    for (std::uint32_t selected : {1u, 0u}) {
+      for (std::uint32_t lane = 0; lane < 8; lane++) {
+        if (((mask >> lane) & 1u) == selected)
+          table[mask] |= lane << (4 * position++);
+      }
+    }
+  }
+  return table;
+}();
+
+[[gnu::target("avx2")]] __m256i load(const std::int32_t *from) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(from));
+}
+
+[[gnu::target("avx2")]] void store(std::int32_t *to, __m256i values) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(to), values);
+}
+
+// Moves the lanes of values less than pivot to the front of the register and
+// writes the whole register both at left and ending at right, so that the
+// small lanes extend the left side and the others the right side.
+[[gnu::target("avx2,popcnt")]] void store_partitioned(__m256i values,
+                                                      __m256i pivot,
+                                                      std::int32_t *&left,
+                                                      std::int32_t *&right) {
+  const __m256i less = _mm256_cmpgt_epi32(pivot, values);
+  const auto mask =
+      static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+  const __m256i order = _mm256_srlv_epi32(
+      _mm256_set1_epi32(static_cast<int>(compress_table[mask])),
+      _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28));
+  const __m256i ordered = _mm256_permutevar8x32_epi32(values, order);
+
+  const int count = std::popcount(mask);
+  store(left, ordered);
+  store(right - 8, ordered);
+  left += count;
+  right -= 8 - count;
+}
+
+// One step of a bitonic network on 8 lanes: lane i is compared with lane
+// i ^ J, and the pair is put in ascending order if i & K is zero.
+template <int J, int K>
+[[gnu::target("avx2")]] __m256i bitonic_step(__m256i values) {
+  constexpr int take_max = [] {
+    int mask = 0;
+    for (int lane = 0; lane < 8; lane++) {
+      if (((lane & J) != 0) == ((lane & K) == 0))
+        mask |= 1 << lane;
+    }
+    return mask;
+  }();
+
+  const __m256i partner = _mm256_permutevar8x32_epi32(
+      values, _mm256_setr_epi32(0 ^ J, 1 ^ J, 2 ^ J, 3 ^ J, 4 ^ J, 5 ^ J,
+                                6 ^ J, 7 ^ J));
+  return _mm256_blend_epi32(_mm256_min_epi32(values, partner),
+                            _mm256_max_epi32(values, partner), take_max);
+}
+
+// Sorts a bitonic sequence of 8 lanes.
+[[gnu::target("avx2")]] __m256i bitonic_merge8(__m256i values) {
+  values = bitonic_step<4, 8>(values);
+  values = bitonic_step<2, 8>(values);
+  return bitonic_step<1, 8>(values);
+}
+
+[[gnu::target("avx2")]] __m256i bitonic_sort8(__m256i values) {
+  values = bitonic_step<1, 2>(values);
+  values = bitonic_step<2, 4>(values);
+  values = bitonic_step<1, 4>(values);
+  return bitonic_merge8(values);
+}
+} // namespace
+
+bool supported() {
+  static const bool result = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+  }();
+  return result;
+}
+
+[[gnu::target("avx2,popcnt")]] std::int32_t *
+partition(std::int32_t *first, std::int32_t *last, std::int32_t pivot) {
+  if (last - first < 16) {
+    return std::partition(first, last,
+                          [pivot](std::int32_t value) { return value < pivot; });
+  }
+
+  // Both ends are loaded up front, which frees 8 slots on either side. Then
+  // every register is read from the side with fewer free slots, so both
+  // sides always have room for a full store.
+  const __m256i pivots = _mm256_set1_epi32(pivot);
+  const __m256i head = load(first);
+  const __m256i tail = load(last - 8);
+  std::int32_t *read_left = first + 8;
+  std::int32_t *read_right = last - 8;
+  std::int32_t *write_left = first;
+  std::int32_t *write_right = last;
+
+  while (read_right - read_left >= 8) {
+    __m256i values;
+    if (read_left - write_left <= write_right - read_right) {
+      values = load(read_left);
+      read_left += 8;
+    } else {
+      read_right -= 8;
+      values = load(read_right);
+    }
+    store_partitioned(values, pivots, write_left, write_right);
+  }
+
+  // Fewer than 8 elements are left unread. They are copied out first, as the
+  // writes below may land on them.
+  std::int32_t rest[8];
+  const std::int32_t *rest_end = std::copy(read_left, read_right, rest);
+  for (const std::int32_t *value = rest; value != rest_end; value++) {
+    if (*value < pivot)
+      *write_left++ = *value;
+    else
+      *--write_right = *value;
+  }
+
+  store_partitioned(head, pivots, write_left, write_right);
+  store_partitioned(tail, pivots, write_left, write_right);
+  return write_left;
+}
+
+[[gnu::target("avx2")]] void sort16(std::int32_t *first, std::size_t size) {
+  // Missing elements are padded with the largest value, which sorts last and
+  // is not stored back.
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i padding =
+      _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max());
+  const auto count = static_cast<int>(size);
+  const __m256i low_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), lanes);
+  const __m256i high_mask =
+      _mm256_cmpgt_epi32(_mm256_set1_epi32(count - 8), lanes);
+
+  __m256i low = _mm256_blendv_epi8(
+      padding, _mm256_maskload_epi32(first, low_mask), low_mask);
+  __m256i high = _mm256_blendv_epi8(
+      padding, _mm256_maskload_epi32(first + 8, high_mask), high_mask);
+
+  // Two sorted halves, one of them reversed, form a bitonic sequence of 16.
+  low = bitonic_sort8(low);
+  high = _mm256_permutevar8x32_epi32(bitonic_sort8(high),
+                                     _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+  const __m256i smaller = _mm256_min_epi32(low, high);
+  const __m256i larger = _mm256_max_epi32(low, high);
+
+  _mm256_maskstore_epi32(first, low_mask, bitonic_merge8(smaller));
+  _mm256_maskstore_epi32(first + 8, high_mask, bitonic_merge8(larger));
+}
+#else
+bool supported() { return false; }
+
+std::int32_t *partition(std::int32_t *first, std::int32_t *last,
+                        std::int32_t pivot) {
+  return std::partition(first, last,
+                        [pivot](std::int32_t value) { return value < pivot; });
+}
+
+void sort16(std::int32_t *first, std::size_t size) {
+  std::sort(first, first + size);
+}
+#endif
+} // namespace mse::avx2
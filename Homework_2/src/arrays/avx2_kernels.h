@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// AVX2 kernels of mse::sort. They are compiled for AVX2 regardless of the
+// build flags, so callers must check supported() first.
+namespace mse::avx2 {
+
+// Whether the running CPU supports AVX2.
+[[nodiscard]] bool supported();
+
+// Partitions [first, last) in place: elements less than pivot end up first.
+// Returns the position of the first element not less than pivot.
+std::int32_t *partition(std::int32_t *first, std::int32_t *last,
+                        std::int32_t pivot);
+
+// Sorts at most 16 elements with a bitonic network held in two registers.
+void sort16(std::int32_t *first, std::size_t size);
+
+} // namespace mse::avx2
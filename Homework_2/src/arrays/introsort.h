@@ -0,0 +1,448 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// The comparison sort behind mse::sort and friends: a pattern-defeating
+// introsort that works on positions of a sequence rather than on iterators,
+// so that keys and their payloads can live in separate arrays.
+//
+// A sequence supplies
+//   key(i)            the sort key at position i;
+//   take(i), put(i, value)
+//                     move the element at i out, and an element into i;
+//   key_of(value)     the sort key of a taken element;
+//   swap(i, j)        swap two elements;
+//   less(a, b)        the order of two keys.
+// It may also supply, to plug in SIMD kernels,
+//   partition_block(left, right, pivot)
+//                     partition [left, right) around the pivot key, returning
+//                     the first position not less than it, or nullopt to
+//                     decline;
+//   small_sort(begin, end)
+//                     sort a short range, returning false to decline.
+namespace mse::detail {
+
+// Ranges shorter than this are finished by insertion sort.
+inline constexpr std::size_t insertion_sort_threshold = 24;
+
+// From this size on the pivot is Tukey's ninther instead of a median of three.
+inline constexpr std::size_t ninther_threshold = 128;
+
+// A partition that moved nothing is tried to be finished by insertion sort,
+// but it is abandoned after this many element moves.
+inline constexpr std::size_t partial_insertion_sort_limit = 8;
+
+template <typename T, typename Compare> class pointer_sequence {
+public:
+  using value_type = T;
+
+  pointer_sequence(T *data, Compare compare)
+      : data_(data), compare_(std::move(compare)) {}
+
+  const T &key(std::size_t i) const { return data_[i]; }
+  T take(std::size_t i) { return std::move(data_[i]); }
+  void put(std::size_t i, T &&value) { data_[i] = std::move(value); }
+  static const T &key_of(const T &value) { return value; }
+
+  void swap(std::size_t i, std::size_t j) {
+    using std::swap;
+    swap(data_[i], data_[j]);
+  }
+
+  bool less(const T &a, const T &b) const { return compare_(a, b); }
+
+private:
+  T *data_;
+  Compare compare_;
+};
+
+// Keys and payloads in two arrays of equal length, moved in lockstep.
+template <typename K, typename V, typename Compare> class key_value_sequence {
+public:
+  using value_type = std::pair<K, V>;
+
+  key_value_sequence(K *keys, V *values, Compare compare)
+      : keys_(keys), values_(values), compare_(std::move(compare)) {}
+
+  const K &key(std::size_t i) const { return keys_[i]; }
+
+  value_type take(std::size_t i) {
+    return {std::move(keys_[i]), std::move(values_[i])};
+  }
+
+  void put(std::size_t i, value_type &&value) {
+    keys_[i] = std::move(value.first);
+    values_[i] = std::move(value.second);
+  }
+
+  static const K &key_of(const value_type &value) { return value.first; }
+
+  void swap(std::size_t i, std::size_t j) {
+    using std::swap;
+    swap(keys_[i], keys_[j]);
+    swap(values_[i], values_[j]);
+  }
+
+  bool less(const K &a, const K &b) const { return compare_(a, b); }
+
+private:
+  K *keys_;
+  V *values_;
+  Compare compare_;
+};
+
+template <typename Sequence>
+void insertion_sort(Sequence &sequence, std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin + 1; i < end; i++) {
+    if (!sequence.less(sequence.key(i), sequence.key(i - 1)))
+      continue;
+
+    auto value = sequence.take(i);
+    std::size_t j = i;
+    do {
+      sequence.put(j, sequence.take(j - 1));
+      j--;
+    } while (j != begin &&
+             sequence.less(Sequence::key_of(value), sequence.key(j - 1)));
+    sequence.put(j, std::move(value));
+  }
+}
+
+// Insertion sort that gives up once too many elements had to move, returning
+// whether the range ended up sorted.
+template <typename Sequence>
+bool partial_insertion_sort(Sequence &sequence, std::size_t begin,
+                            std::size_t end) {
+  std::size_t moves = 0;
+  for (std::size_t i = begin + 1; i < end; i++) {
+    if (!sequence.less(sequence.key(i), sequence.key(i - 1)))
+      continue;
+
+    auto value = sequence.take(i);
+    std::size_t j = i;
+    do {
+      sequence.put(j, sequence.take(j - 1));
+      j--;
+    } while (j != begin &&
+             sequence.less(Sequence::key_of(value), sequence.key(j - 1)));
+    sequence.put(j, std::move(value));
+
+    moves += i - j;
+    if (moves > partial_insertion_sort_limit)
+      return false;
+  }
+  return true;
+}
+
+template <typename Sequence>
+void sift_down(Sequence &sequence, std::size_t begin, std::size_t size,
+               std::size_t root) {
+  auto value = sequence.take(begin + root);
+  for (std::size_t child = 2 * root + 1; child < size; child = 2 * root + 1) {
+    if (child + 1 < size && sequence.less(sequence.key(begin + child),
+                                          sequence.key(begin + child + 1)))
+      child++;
+    if (!sequence.less(Sequence::key_of(value), sequence.key(begin + child)))
+      break;
+    sequence.put(begin + root, sequence.take(begin + child));
+    root = child;
+  }
+  sequence.put(begin + root, std::move(value));
+}
+
+template <typename Sequence>
+void heap_sort(Sequence &sequence, std::size_t begin, std::size_t end) {
+  const std::size_t size = end - begin;
+  for (std::size_t root = size / 2; root-- > 0;)
+    sift_down(sequence, begin, size, root);
+  for (std::size_t last = size - 1; last > 0; last--) {
+    sequence.swap(begin, begin + last);
+    sift_down(sequence, begin, last, 0);
+  }
+}
+
+template <typename Sequence>
+void sort3(Sequence &sequence, std::size_t a, std::size_t b, std::size_t c) {
+  if (sequence.less(sequence.key(b), sequence.key(a)))
+    sequence.swap(a, b);
+  if (sequence.less(sequence.key(c), sequence.key(b)))
+    sequence.swap(b, c);
+  if (sequence.less(sequence.key(b), sequence.key(a)))
+    sequence.swap(a, b);
+}
+
+// Moves the pivot to begin. Either way the range also ends with an element
+// not less than the pivot, which the unguarded scans of partition rely on.
+template <typename Sequence>
+void choose_pivot(Sequence &sequence, std::size_t begin, std::size_t end) {
+  const std::size_t size = end - begin;
+  const std::size_t middle = begin + size / 2;
+  if (size > ninther_threshold) {
+    sort3(sequence, begin, middle, end - 1);
+    sort3(sequence, begin + 1, middle - 1, end - 2);
+    sort3(sequence, begin + 2, middle + 1, end - 3);
+    sort3(sequence, middle - 1, middle, middle + 1);
+    sequence.swap(begin, middle);
+  } else {
+    sort3(sequence, middle, begin, end - 1);
+  }
+}
+
+struct partition_result {
+  std::size_t pivot;
+  // Whether the range already was partitioned, so that nothing was swapped.
+  bool untouched;
+};
+
+// Hoare partition around the element at begin: elements less than the pivot
+// end up before it, the others after it.
+template <typename Sequence>
+partition_result partition(Sequence &sequence, std::size_t begin,
+                           std::size_t end) {
+  auto pivot = sequence.take(begin);
+  const auto &key = Sequence::key_of(pivot);
+  std::size_t left = begin;
+  std::size_t right = end;
+
+  while (sequence.less(sequence.key(++left), key)) {
+  }
+  if (left - 1 == begin) {
+    while (left < right && !sequence.less(sequence.key(--right), key)) {
+    }
+  } else {
+    while (!sequence.less(sequence.key(--right), key)) {
+    }
+  }
+
+  // Everything before left is less than the pivot, everything after right
+  // is not.
+  const bool untouched = left >= right;
+  std::optional<std::size_t> split;
+  if constexpr (requires { sequence.partition_block(left, right, key); }) {
+    if (!untouched)
+      split = sequence.partition_block(left, right + 1, key);
+  }
+
+  if (split) {
+    left = *split;
+  } else {
+    while (left < right) {
+      sequence.swap(left, right);
+      while (sequence.less(sequence.key(++left), key)) {
+      }
+      while (!sequence.less(sequence.key(--right), key)) {
+      }
+    }
+  }
+
+  const std::size_t position = left - 1;
+  sequence.put(begin, sequence.take(position));
+  sequence.put(position, std::move(pivot));
+  return {position, untouched};
+}
+
+// Partition for a pivot equal to the element just before the range: elements
+// equal to the pivot end up before it, greater ones after it. Everything
+// before the returned position then equals the pivot and is done, so runs of
+// duplicates cost linear time.
+template <typename Sequence>
+std::size_t partition_equal(Sequence &sequence, std::size_t begin,
+                            std::size_t end) {
+  auto pivot = sequence.take(begin);
+  const auto &key = Sequence::key_of(pivot);
+  std::size_t left = begin;
+  std::size_t right = end;
+
+  while (sequence.less(key, sequence.key(--right))) {
+  }
+  if (right + 1 == end) {
+    while (left < right && !sequence.less(key, sequence.key(++left))) {
+    }
+  } else {
+    while (!sequence.less(key, sequence.key(++left))) {
+    }
+  }
+
+  while (left < right) {
+    sequence.swap(left, right);
+    while (sequence.less(key, sequence.key(--right))) {
+    }
+    while (!sequence.less(key, sequence.key(++left))) {
+    }
+  }
+
+  sequence.put(begin, sequence.take(right));
+  sequence.put(right, std::move(pivot));
+  return right;
+}
+
+// Swaps a few elements of a side that came out very short, so that a pattern
+// which fooled the pivot choice once does not keep doing so.
+template <typename Sequence>
+void break_patterns(Sequence &sequence, std::size_t begin, std::size_t end) {
+  const std::size_t size = end - begin;
+  if (size < insertion_sort_threshold)
+    return;
+
+  const std::size_t quarter = size / 4;
+  sequence.swap(begin, begin + quarter);
+  sequence.swap(end - 1, end - quarter);
+  if (size > ninther_threshold) {
+    sequence.swap(begin + 1, begin + quarter + 1);
+    sequence.swap(begin + 2, begin + quarter + 2);
+    sequence.swap(end - 2, end - quarter - 1);
+    sequence.swap(end - 3, end - quarter - 2);
+  }
+}
+
+// Pattern-defeating quicksort. Recursing only into the smaller side bounds
+// the stack depth by log2(n); after log2(n) badly unbalanced partitions the
+// range is heap sorted instead, so the worst case is O(n log n).
+// leftmost tells whether an element not greater than the range precedes it.
+template <typename Sequence>
+void introsort(Sequence &sequence, std::size_t begin, std::size_t end,
+               int bad_allowed, bool leftmost) {
+  while (true) {
+    const std::size_t size = end - begin;
+    if constexpr (requires { sequence.small_sort(begin, end); }) {
+      if (sequence.small_sort(begin, end))
+        return;
+    }
+    if (size < insertion_sort_threshold) {
+      insertion_sort(sequence, begin, end);
+      return;
+    }
+
+    choose_pivot(sequence, begin, end);
+    if (!leftmost &&
+        !sequence.less(sequence.key(begin - 1), sequence.key(begin))) {
+      begin = partition_equal(sequence, begin, end) + 1;
+      continue;
+    }
+
+    const auto [pivot, untouched] = partition(sequence, begin, end);
+    const std::size_t left_size = pivot - begin;
+    const std::size_t right_size = end - (pivot + 1);
+
+    if (left_size < size / 8 || right_size < size / 8) {
+      if (--bad_allowed == 0) {
+        heap_sort(sequence, begin, end);
+        return;
+      }
+      break_patterns(sequence, begin, pivot);
+      break_patterns(sequence, pivot + 1, end);
+    } else if (untouched && partial_insertion_sort(sequence, begin, pivot) &&
+               partial_insertion_sort(sequence, pivot + 1, end)) {
+      return;
+    }
+
+    if (left_size < right_size) {
+      introsort(sequence, begin, pivot, bad_allowed, leftmost);
+      begin = pivot + 1;
+      leftmost = false;
+    } else {
+      introsort(sequence, pivot + 1, end, bad_allowed, false);
+      end = pivot;
+    }
+  }
+}
+
+template <typename Sequence> void sort(Sequence &sequence, std::size_t size) {
+  introsort(sequence, 0, size, static_cast<int>(std::bit_width(size)), true);
+}
+
+// Partitions of select may scan this many times the size of the input before
+// select falls back to medians of medians. Random input needs about 3.
+inline constexpr std::size_t select_budget_factor = 6;
+
+template <typename Sequence>
+void select(Sequence &sequence, std::size_t begin, std::size_t end,
+            std::size_t nth, std::size_t budget, bool leftmost);
+
+// Moves the median of the medians of groups of five to begin. At least 3/10
+// of the range is not greater and 3/10 not less than it.
+template <typename Sequence>
+void median_of_medians(Sequence &sequence, std::size_t begin,
+                       std::size_t end) {
+  std::size_t groups = 0;
+  for (std::size_t group = begin; group + 5 <= end; group += 5) {
+    insertion_sort(sequence, group, group + 5);
+    sequence.swap(begin + groups, group + 2);
+    groups++;
+  }
+
+  select(sequence, begin, begin + groups, begin + groups / 2, 0, true);
+  sequence.swap(begin, begin + groups / 2);
+}
+
+// Introselect: quickselect with the pivots of introsort, descending only into
+// the side holding nth. Every partition spends its size from budget; once the
+// budget runs out, pivots become medians of medians, so the total work is
+// O(n) even when an adversary spoils every cheap pivot. leftmost is as in
+// introsort.
+template <typename Sequence>
+void select(Sequence &sequence, std::size_t begin, std::size_t end,
+            std::size_t nth, std::size_t budget, bool leftmost) {
+  while (end - begin >= insertion_sort_threshold) {
+    const std::size_t size = end - begin;
+    if (budget >= size) {
+      budget -= size;
+      choose_pivot(sequence, begin, end);
+    } else {
+      budget = 0;
+      median_of_medians(sequence, begin, end);
+    }
+
+    if (!leftmost &&
+        !sequence.less(sequence.key(begin - 1), sequence.key(begin))) {
+      // [begin, pivot] is all equal to the pivot.
+      const std::size_t pivot = partition_equal(sequence, begin, end);
+      if (nth <= pivot)
+        return;
+      begin = pivot + 1;
+      continue;
+    }
+
+    const std::size_t pivot = partition(sequence, begin, end).pivot;
+    if (pivot == nth)
+      return;
+
+    if (nth < pivot) {
+      end = pivot;
+    } else {
+      begin = pivot + 1;
+      leftmost = false;
+    }
+  }
+  insertion_sort(sequence, begin, end);
+}
+
+// Puts the element at nth that would be there if the sequence was sorted,
+// with no greater element before it and no smaller one after it.
+template <typename Sequence>
+void select(Sequence &sequence, std::size_t size, std::size_t nth) {
+  select(sequence, 0, size, nth, select_budget_factor * size, true);
+}
+
+// Whether T and Compare ask for int32 in ascending order, which has a faster
+// path with radix sort and SIMD kernels.
+template <typename T, typename Compare>
+inline constexpr bool is_int32_ascending =
+    std::is_same_v<T, std::int32_t> &&
+    (std::is_same_v<Compare, std::less<>> ||
+     std::is_same_v<Compare, std::less<std::int32_t>>);
+
+// The int32 sort of mse::sort(std::vector<std::int32_t> &); the templates of
+// arrays.h forward to it when is_int32_ascending holds.
+void sort_int32(std::int32_t *data, std::size_t size);
+
+// select for int32 in ascending order, with the SIMD partition.
+void select_int32(std::int32_t *data, std::size_t size, std::size_t nth);
+
+} // namespace mse::detail
@@ -0,0 +1,68 @@
+#include "mapped_file.h"
+#include "arrays.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mse {
+
+detail::mapped_file::mapped_file(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to open file: " + path);
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::generic_category(),
+                            "Failed to stat file: " + path);
+  }
+
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ != 0) {
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data_ == MAP_FAILED) {
+      const int error = errno;
+      ::close(fd);
+      data_ = nullptr;
+      throw std::system_error(error, std::generic_category(),
+                              "Failed to map file: " + path);
+    }
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+  ::close(fd);
+}
+
+detail::mapped_file::~mapped_file() {
+  if (data_ != nullptr)
+    ::munmap(data_, size_);
+}
+
+square find_max_square_packed(const std::string &path, std::size_t cols) {
+  return find_max_square_packed(path, cols, parallel_policy{1});
+}
+
+square find_max_square_packed(const std::string &path, std::size_t cols,
+                              parallel_policy policy) {
+  const detail::mapped_file file(path);
+  const std::size_t row_words = packed_row_words(cols);
+  if (row_words == 0)
+    return {};
+  if (file.size() % (row_words * sizeof(std::uint64_t)) != 0)
+    throw std::invalid_argument(
+        "find_max_square_packed: file size is not a whole number of rows.");
+
+  const matrix_view<const std::uint64_t> words(
+      static_cast<const std::uint64_t *>(file.data()),
+      file.size() / (row_words * sizeof(std::uint64_t)), row_words);
+  return find_max_square_packed(words, cols, policy);
+}
+
+} // namespace mse
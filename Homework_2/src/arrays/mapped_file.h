@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace mse::detail {
+
+// Read-only memory mapping of a whole file. Throws std::system_error if the
+// file cannot be opened or mapped.
+class mapped_file {
+public:
+  explicit mapped_file(const std::string &path);
+  ~mapped_file();
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  [[nodiscard]] const void *data() const { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+private:
+  void *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+} // namespace mse::detail
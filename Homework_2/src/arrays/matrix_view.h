@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace mse {
+
+// A non-owning view of a row-major matrix: rows of cols elements each, with
+// consecutive rows stride elements apart. A submatrix of a view is a view of
+// the same buffer.
+template <typename T> class matrix_view {
+public:
+  matrix_view() = default;
+
+  // A densely packed matrix: stride equals cols.
+  matrix_view(T *data, std::size_t rows, std::size_t cols)
+      : matrix_view(data, rows, cols, cols) {}
+
+  // Throws std::invalid_argument if stride is less than cols.
+  matrix_view(T *data, std::size_t rows, std::size_t cols, std::size_t stride)
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {
+    if (stride < cols)
+      throw std::invalid_argument("matrix_view: stride is less than cols");
+  }
+
+  // A view of mutable elements is also a view of const ones.
+  template <typename U>
+    requires(!std::is_same_v<U, T> && std::is_convertible_v<U (*)[], T (*)[]>)
+  matrix_view(matrix_view<U> other)
+      : data_(other.data()), rows_(other.rows()), cols_(other.cols()),
+        stride_(other.stride()) {}
+
+  [[nodiscard]] T *data() const { return data_; }
+  [[nodiscard]] std::size_t rows() const { return rows_; }
+  [[nodiscard]] std::size_t cols() const { return cols_; }
+  [[nodiscard]] std::size_t stride() const { return stride_; }
+  [[nodiscard]] bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+  [[nodiscard]] std::span<T> row(std::size_t i) const {
+    return {data_ + i * stride_, cols_};
+  }
+
+  T &operator()(std::size_t i, std::size_t j) const {
+    return data_[i * stride_ + j];
+  }
+
+  // The rows x cols block whose top-left element is (row, col). Throws
+  // std::out_of_range if it does not fit in this view.
+  [[nodiscard]] matrix_view submatrix(std::size_t row, std::size_t col,
+                                      std::size_t rows,
+                                      std::size_t cols) const {
+    if (row > rows_ || rows > rows_ - row || col > cols_ || cols > cols_ - col)
+      throw std::out_of_range("matrix_view: submatrix out of range");
+    return {data_ + row * stride_ + col, rows, cols, stride_};
+  }
+
+private:
+  T *data_ = nullptr;
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t stride_ = 0;
+};
+
+} // namespace mse
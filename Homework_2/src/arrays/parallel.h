@@ -0,0 +1,35 @@
+#pragma once
+
+#include "arrays.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Threading helpers shared by the parallel overloads of the arrays module.
+namespace mse::detail {
+
+// Runs work(0), ..., work(parts - 1) on separate threads, one of them being
+// the calling thread.
+template <typename Work> void run_parallel(std::size_t parts, Work &&work) {
+  std::vector<std::thread> workers;
+  workers.reserve(parts - 1);
+  for (std::size_t k = 1; k < parts; k++)
+    workers.emplace_back(work, k);
+  work(0);
+  for (auto &worker : workers)
+    worker.join();
+}
+
+// Threads to use for size elements under policy, so that every thread gets
+// at least min_size of them; 1 means sequential.
+inline std::size_t thread_count(parallel_policy policy, std::size_t size,
+                                std::size_t min_size) {
+  std::size_t threads = policy.threads;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  return std::max<std::size_t>(1, std::min(threads, size / min_size));
+}
+
+} // namespace mse::detail
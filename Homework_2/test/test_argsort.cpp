@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/arrays.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+
+using namespace mse;
+
+TEST_CASE("argsort_empty", "[argsort]") {
+  std::vector<std::int32_t> input;
+  REQUIRE(argsort(std::span<const std::int32_t>(input)).empty());
+}
+
+TEST_CASE("argsort_small", "[argsort]") {
+  std::vector<std::int32_t> input = {30, -10, 20, 0};
+  const auto res = argsort(std::span<const std::int32_t>(input));
+  REQUIRE(res == std::vector<std::uint32_t>{1, 3, 2, 0});
+}
+
+TEST_CASE("argsort_strings_descending", "[argsort]") {
+  std::vector<std::string> input = {"b", "c", "a"};
+  const auto res =
+      argsort(std::span<const std::string>(input), std::greater<>());
+  REQUIRE(res == std::vector<std::uint32_t>{1, 0, 2});
+}
+
+TEST_CASE("argsort_random", "[argsort]") {
+  std::mt19937 generator(9);
+  std::uniform_int_distribution<std::int32_t> distribution(-1000, 1000);
+  std::vector<std::int32_t> input(100000);
+  for (auto &element : input)
+    element = distribution(generator);
+
+  const auto res = argsort(std::span<const std::int32_t>(input));
+
+  std::vector<std::uint32_t> indices = res;
+  std::sort(indices.begin(), indices.end());
+  for (std::uint32_t i = 0; i < indices.size(); i++)
+    REQUIRE(indices[i] == i);
+  for (std::size_t i = 1; i < res.size(); i++)
+    REQUIRE(input[res[i - 1]] <= input[res[i]]);
+}
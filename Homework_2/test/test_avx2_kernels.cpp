@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/avx2_kernels.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace mse;
+
+namespace {
+std::vector<std::int32_t> random_elements(std::size_t size,
+                                          std::int32_t modulo) {
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<std::int32_t> distribution(-modulo, modulo);
+  std::vector<std::int32_t> elements(size);
+  for (auto &element : elements)
+    element = distribution(generator);
+  return elements;
+}
+} // namespace
+
+TEST_CASE("avx2_partition_all_sizes", "[avx2]") {
+  // Nothing to test on a CPU without AVX2: the kernels are never called there.
+  if (!avx2::supported())
+    return;
+
+  for (std::size_t size = 0; size < 200; size++) {
+    for (std::int32_t modulo : {2, 1000}) {
+      std::vector<std::int32_t> input = random_elements(size, modulo);
+      for (std::int32_t pivot : {-modulo - 1, -1, 0, 1, modulo + 1}) {
+        std::vector<std::int32_t> output = input;
+        std::int32_t *split =
+            avx2::partition(output.data(), output.data() + size, pivot);
+        auto less = [pivot](std::int32_t value) { return value < pivot; };
+
+        REQUIRE(std::is_permutation(output.begin(), output.end(),
+                                    input.begin()));
+        REQUIRE(std::all_of(output.data(), split, less));
+        REQUIRE(std::none_of(split, output.data() + size, less));
+      }
+    }
+  }
+}
+
+TEST_CASE("avx2_sort16_all_sizes", "[avx2]") {
+  // Nothing to test on a CPU without AVX2: the kernels are never called there.
+  if (!avx2::supported())
+    return;
+
+  for (std::size_t size = 0; size <= 16; size++) {
+    for (std::int32_t modulo :
+         {1, 3, std::numeric_limits<std::int32_t>::max()}) {
+      std::vector<std::int32_t> input = random_elements(size, modulo);
+      input.push_back(42);
+      std::vector<std::int32_t> expected = input;
+      std::sort(expected.begin(), expected.begin() + size);
+
+      avx2::sort16(input.data(), size);
+      // The element after the range must stay untouched.
+      REQUIRE(input == expected);
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/matrix_view.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace mse;
+
+TEST_CASE("matrix_view_dense", "[matrix_view]") {
+  std::vector<std::int32_t> buffer = {1, 2, 3, 4, 5, 6};
+  const matrix_view<std::int32_t> matrix(buffer.data(), 2, 3);
+  REQUIRE(matrix.rows() == 2);
+  REQUIRE(matrix.cols() == 3);
+  REQUIRE(matrix.stride() == 3);
+  REQUIRE(matrix(1, 0) == 4);
+  REQUIRE(matrix.row(1)[2] == 6);
+
+  matrix(0, 1) = 20;
+  REQUIRE(buffer[1] == 20);
+}
+
+TEST_CASE("matrix_view_strided", "[matrix_view]") {
+  // Two rows of two elements, padded to four.
+  std::vector<std::int32_t> buffer = {1, 2, -1, -1, 3, 4, -1, -1};
+  const matrix_view<const std::int32_t> matrix(buffer.data(), 2, 2, 4);
+  REQUIRE(matrix(1, 0) == 3);
+  REQUIRE(matrix.row(1).size() == 2);
+}
+
+TEST_CASE("matrix_view_submatrix", "[matrix_view]") {
+  std::vector<std::int32_t> buffer(20);
+  for (std::size_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = static_cast<std::int32_t>(i);
+  const matrix_view<std::int32_t> matrix(buffer.data(), 4, 5);
+
+  const auto block = matrix.submatrix(1, 2, 2, 3);
+  REQUIRE(block.rows() == 2);
+  REQUIRE(block.cols() == 3);
+  REQUIRE(block.stride() == 5);
+  REQUIRE(block(0, 0) == 7);
+  REQUIRE(block(1, 2) == 14);
+
+  const auto inner = block.submatrix(1, 1, 1, 2);
+  REQUIRE(inner(0, 0) == 13);
+
+  REQUIRE(matrix.submatrix(4, 5, 0, 0).empty());
+}
+
+TEST_CASE("matrix_view_submatrix_out_of_range", "[matrix_view]") {
+  std::vector<std::int32_t> buffer(20);
+  const matrix_view<std::int32_t> matrix(buffer.data(), 4, 5);
+  REQUIRE_THROWS_AS(matrix.submatrix(0, 0, 5, 1), std::out_of_range);
+  REQUIRE_THROWS_AS(matrix.submatrix(3, 0, 2, 1), std::out_of_range);
+  REQUIRE_THROWS_AS(matrix.submatrix(0, 4, 1, 2), std::out_of_range);
+  REQUIRE_THROWS_AS(matrix.submatrix(5, 0, 0, 0), std::out_of_range);
+}
+
+TEST_CASE("matrix_view_stride_less_than_cols", "[matrix_view]") {
+  std::vector<std::int32_t> buffer(20);
+  REQUIRE_THROWS_AS(matrix_view<std::int32_t>(buffer.data(), 4, 5, 4),
+                    std::invalid_argument);
+}
+
+TEST_CASE("matrix_view_const_conversion", "[matrix_view]") {
+  std::vector<std::int32_t> buffer = {1, 2, 3, 4};
+  const matrix_view<std::int32_t> matrix(buffer.data(), 2, 2);
+  const matrix_view<const std::int32_t> view = matrix;
+  REQUIRE(view.data() == buffer.data());
+  REQUIRE(view(1, 1) == 4);
+}
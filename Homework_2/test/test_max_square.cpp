@@ -2,8 +2,45 @@
 
 #include <arrays/arrays.h>
 
+#include <algorithm>
+#include <random>
+
 using namespace mse;
 
+namespace {
+// The area of the largest square of ones, trying every corner and side.
+std::size_t brute_force_max_square(matrix_view<const std::int8_t> matrix) {
+  std::size_t max_side = 0;
+  for (std::size_t i = 0; i < matrix.rows(); i++) {
+    for (std::size_t j = 0; j < matrix.cols(); j++) {
+      // Each side adds a row at the bottom and a column at the right.
+      for (std::size_t side = 1;
+           i + side <= matrix.rows() && j + side <= matrix.cols(); side++) {
+        bool ones = true;
+        for (std::size_t k = 0; k < side && ones; k++)
+          ones = matrix(i + side - 1, j + k) == 1 &&
+                 matrix(i + k, j + side - 1) == 1;
+        if (!ones)
+          break;
+        max_side = std::max(max_side, side);
+      }
+    }
+  }
+  return max_side * max_side;
+}
+
+// A rows x cols matrix in which each element is 1 with the given probability.
+std::vector<std::int8_t> random_bitmap(std::mt19937 &generator,
+                                       std::size_t rows, std::size_t cols,
+                                       double density) {
+  std::bernoulli_distribution one(density);
+  std::vector<std::int8_t> bitmap(rows * cols);
+  for (auto &value : bitmap)
+    value = one(generator) ? 1 : 0;
+  return bitmap;
+}
+} // namespace
+
 TEST_CASE("max_square_empty_matrix", "[max_square]") {
   std::vector<std::vector<std::int8_t>> input;
   const auto res = find_max_square(input);
@@ -175,3 +212,71 @@ TEST_CASE("max_square_matrix_5x5_zero", "[max_square]") {
   const auto res = find_max_square(input);
   REQUIRE(res == 0);
 }
+
+TEST_CASE("max_square_view_flat_buffer", "[max_square]") {
+  const std::vector<std::int8_t> buffer = {
+      0, 1, 1, 1, //
+      1, 1, 1, 1, //
+      0, 1, 1, 1, //
+  };
+  const auto res =
+      find_max_square(matrix_view<const std::int8_t>(buffer.data(), 3, 4));
+  REQUIRE(res == 9);
+}
+
+TEST_CASE("max_square_view_submatrix", "[max_square]") {
+  // A 3x3 square of ones, of which the submatrix keeps a 2x2 corner.
+  const std::vector<std::int8_t> buffer = {
+      0, 0, 0, 0, 0, //
+      0, 1, 1, 1, 0, //
+      0, 1, 1, 1, 0, //
+      0, 1, 1, 1, 0, //
+      0, 0, 0, 0, 0, //
+  };
+  const matrix_view<const std::int8_t> matrix(buffer.data(), 5, 5);
+  REQUIRE(find_max_square(matrix) == 9);
+  REQUIRE(find_max_square(matrix.submatrix(2, 2, 3, 3)) == 4);
+  REQUIRE(find_max_square(matrix.submatrix(0, 0, 5, 1)) == 0);
+}
+
+TEST_CASE("max_square_view_empty", "[max_square]") {
+  REQUIRE(find_max_square(matrix_view<const std::int8_t>()) == 0);
+}
+
+TEST_CASE("max_square_random_against_brute_force", "[max_square]") {
+  std::mt19937 generator(19);
+  std::uniform_int_distribution<std::size_t> size(0, 40);
+  for (int round = 0; round < 300; round++) {
+    const std::size_t rows = size(generator);
+    const std::size_t cols = size(generator);
+    const double density = 0.5 + 0.5 * (round % 10) / 10.0;
+    const auto bitmap = random_bitmap(generator, rows, cols, density);
+    const matrix_view<const std::int8_t> matrix(bitmap.data(), rows, cols);
+
+    REQUIRE(find_max_square(matrix) == brute_force_max_square(matrix));
+  }
+}
+
+TEST_CASE("max_square_random_submatrix_against_brute_force",
+          "[max_square]") {
+  std::mt19937 generator(20);
+  const auto bitmap = random_bitmap(generator, 60, 60, 0.9);
+  const matrix_view<const std::int8_t> matrix(bitmap.data(), 60, 60);
+  std::uniform_int_distribution<std::size_t> offset(0, 30);
+  for (int round = 0; round < 50; round++) {
+    const auto block =
+        matrix.submatrix(offset(generator), offset(generator), 30, 30);
+    REQUIRE(find_max_square(block) == brute_force_max_square(block));
+  }
+}
+
+TEST_CASE("max_square_random_vector_of_rows", "[max_square]") {
+  std::mt19937 generator(21);
+  const auto bitmap = random_bitmap(generator, 25, 35, 0.85);
+  std::vector<std::vector<std::int8_t>> input(25);
+  for (std::size_t i = 0; i < input.size(); i++)
+    input[i].assign(bitmap.begin() + i * 35, bitmap.begin() + (i + 1) * 35);
+
+  REQUIRE(find_max_square(input) ==
+          brute_force_max_square({bitmap.data(), 25, 35}));
+}
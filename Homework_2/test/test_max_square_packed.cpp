@@ -0,0 +1,239 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/arrays.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+
+using namespace mse;
+
+namespace {
+// A bit-packed rows x cols matrix: each bit is 0 with probability 1 / zero_odds,
+// and the padding bits are set to check that they are ignored.
+std::vector<std::uint64_t> random_packed(std::mt19937_64 &generator,
+                                         std::size_t rows, std::size_t cols,
+                                         std::uint64_t zero_odds) {
+  const std::size_t row_words = packed_row_words(cols);
+  std::vector<std::uint64_t> words(rows * row_words, ~std::uint64_t(0));
+  std::uniform_int_distribution<std::uint64_t> zero(0, rows * cols * 2);
+  const std::uint64_t zeros = rows * cols / zero_odds;
+  for (std::uint64_t z = 0; z < zeros; z++) {
+    const std::uint64_t cell = zero(generator) % (rows * cols);
+    const std::size_t i = cell / cols;
+    const std::size_t j = cell % cols;
+    words[i * row_words + j / 64] &= ~(std::uint64_t(1) << (j % 64));
+  }
+  return words;
+}
+
+std::vector<std::int8_t> unpack(const std::vector<std::uint64_t> &words,
+                                std::size_t rows, std::size_t cols) {
+  const std::size_t row_words = packed_row_words(cols);
+  std::vector<std::int8_t> matrix(rows * cols);
+  for (std::size_t i = 0; i < rows; i++) {
+    for (std::size_t j = 0; j < cols; j++)
+      matrix[i * cols + j] = (words[i * row_words + j / 64] >> (j % 64)) & 1;
+  }
+  return matrix;
+}
+
+void require_ones(const std::vector<std::int8_t> &matrix, std::size_t cols,
+                  const square &found) {
+  for (std::size_t i = found.row; i < found.row + found.side; i++) {
+    for (std::size_t j = found.col; j < found.col + found.side; j++)
+      REQUIRE(matrix[i * cols + j] == 1);
+  }
+}
+
+void require_same(const square &a, const square &b) {
+  REQUIRE(a.side == b.side);
+  REQUIRE(a.row == b.row);
+  REQUIRE(a.col == b.col);
+}
+
+// A file in the temporary directory holding words, removed on destruction
+// even when a REQUIRE fails. The name is random, so that concurrent runs of
+// the test do not write to the same file.
+class temp_file {
+public:
+  explicit temp_file(const std::vector<std::uint64_t> &words) {
+    std::random_device device;
+    const std::uint64_t id = (std::uint64_t(device()) << 32) | device();
+    path_ = std::filesystem::temp_directory_path() /
+            ("test_max_square_packed_" + std::to_string(id) + ".bin");
+    std::ofstream file(path_, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(words.data()),
+               static_cast<std::streamsize>(words.size() * sizeof(words[0])));
+  }
+  temp_file(const temp_file &) = delete;
+  temp_file &operator=(const temp_file &) = delete;
+  ~temp_file() {
+    std::error_code error;
+    std::filesystem::remove(path_, error);
+  }
+
+  std::string path() const { return path_.string(); }
+
+private:
+  std::filesystem::path path_;
+};
+} // namespace
+
+TEST_CASE("max_square_packed_row_words", "[max_square_packed]") {
+  REQUIRE(packed_row_words(0) == 0);
+  REQUIRE(packed_row_words(1) == 1);
+  REQUIRE(packed_row_words(64) == 1);
+  REQUIRE(packed_row_words(65) == 2);
+}
+
+TEST_CASE("max_square_packed_empty", "[max_square_packed]") {
+  const auto res = find_max_square_packed(matrix_view<const std::uint64_t>(), 0);
+  REQUIRE(res.side == 0);
+}
+
+TEST_CASE("max_square_packed_position", "[max_square_packed]") {
+  // Rows of 5 columns: a 3x3 square at (1, 2), a 2x2 one at (0, 0).
+  const std::vector<std::uint64_t> words = {
+      0b00011, //
+      0b11111, //
+      0b11100, //
+      0b11100, //
+  };
+  const auto res = find_max_square_packed({words.data(), 4, 1}, 5);
+  require_same(res, {3, 1, 2});
+}
+
+TEST_CASE("max_square_packed_first_of_equal", "[max_square_packed]") {
+  // Two 2x2 squares; the one starting on the earlier row comes first.
+  const std::vector<std::uint64_t> words = {
+      0b11000, //
+      0b11011, //
+      0b00011, //
+  };
+  const auto res = find_max_square_packed({words.data(), 3, 1}, 5);
+  require_same(res, {2, 0, 3});
+}
+
+TEST_CASE("max_square_packed_ignores_padding", "[max_square_packed]") {
+  // Column 0 is zero, column 1 and the padding are ones.
+  const std::vector<std::uint64_t> words(3, ~std::uint64_t(1));
+  const auto res = find_max_square_packed({words.data(), 3, 1}, 2);
+  require_same(res, {1, 0, 1});
+}
+
+TEST_CASE("max_square_packed_across_words", "[max_square_packed]") {
+  // Ones in columns 60 to 69 of 10 rows.
+  std::vector<std::uint64_t> words(2 * 12, 0);
+  for (std::size_t i = 1; i < 11; i++) {
+    words[i * 2] = ~std::uint64_t(0) << 60;
+    words[i * 2 + 1] = 0b111111;
+  }
+  const auto res = find_max_square_packed({words.data(), 12, 2}, 128);
+  require_same(res, {10, 1, 60});
+}
+
+TEST_CASE("max_square_packed_random_against_bytes", "[max_square_packed]") {
+  std::mt19937_64 generator(20);
+  for (std::size_t cols : {1u, 63u, 64u, 65u, 200u}) {
+    for (std::uint64_t zero_odds : {2u, 8u, 64u}) {
+      const std::size_t rows = 150;
+      const auto words = random_packed(generator, rows, cols, zero_odds);
+      const auto matrix = unpack(words, rows, cols);
+
+      const auto res = find_max_square_packed(
+          {words.data(), rows, packed_row_words(cols)}, cols);
+      REQUIRE(res.side * res.side ==
+              find_max_square(
+                  matrix_view<const std::int8_t>(matrix.data(), rows, cols)));
+      require_ones(matrix, cols, res);
+    }
+  }
+}
+
+TEST_CASE("max_square_packed_stream", "[max_square_packed]") {
+  std::mt19937_64 generator(21);
+  const std::size_t rows = 300;
+  const std::size_t cols = 130;
+  const auto words = random_packed(generator, rows, cols, 16);
+  const matrix_view<const std::uint64_t> view(words.data(), rows, 3);
+
+  max_square_stream stream(cols);
+  for (std::size_t i = 0; i < rows; i++)
+    stream.push_row(view.row(i));
+  require_same(stream.result(), find_max_square_packed(view, cols));
+
+  REQUIRE_THROWS_AS(stream.push_row(view.row(0).first(2)),
+                    std::invalid_argument);
+}
+
+TEST_CASE("max_square_packed_parallel", "[max_square_packed]") {
+  // Large enough for the wavefront to use two threads, with many tiles.
+  std::mt19937_64 generator(22);
+  const std::size_t rows = 2048;
+  const std::size_t cols = 4100;
+  const std::size_t row_words = packed_row_words(cols);
+  for (std::uint64_t zero_odds : {8u, 512u}) {
+    const auto words = random_packed(generator, rows, cols, zero_odds);
+    const matrix_view<const std::uint64_t> view(words.data(), rows, row_words);
+
+    const auto sequential = find_max_square_packed(view, cols);
+    for (unsigned threads : {2u, 3u}) {
+      require_same(
+          find_max_square_packed(view, cols, parallel_policy{threads}),
+          sequential);
+    }
+    require_ones(unpack(words, rows, cols), cols, sequential);
+  }
+}
+
+TEST_CASE("max_square_packed_parallel_first_of_equal", "[max_square_packed]") {
+  // Two 5x5 squares in different tiles. The thread that sweeps both reaches
+  // the one at (522, 10) first, on an earlier wavefront, but (0, 3082) comes
+  // first in row-major order.
+  const std::size_t rows = 2048;
+  const std::size_t cols = 8192;
+  const std::size_t row_words = packed_row_words(cols);
+  std::vector<std::uint64_t> words(rows * row_words, 0);
+  for (auto [row, col] : {std::pair<std::size_t, std::size_t>(0, 3082),
+                          std::pair<std::size_t, std::size_t>(522, 10)}) {
+    for (std::size_t i = row; i < row + 5; i++) {
+      for (std::size_t j = col; j < col + 5; j++)
+        words[i * row_words + j / 64] |= std::uint64_t(1) << (j % 64);
+    }
+  }
+  const matrix_view<const std::uint64_t> view(words.data(), rows, row_words);
+
+  require_same(find_max_square_packed(view, cols), {5, 0, 3082});
+  for (unsigned threads : {2u, 3u, 4u}) {
+    require_same(find_max_square_packed(view, cols, parallel_policy{threads}),
+                 {5, 0, 3082});
+  }
+}
+
+TEST_CASE("max_square_packed_file", "[max_square_packed]") {
+  std::mt19937_64 generator(23);
+  const std::size_t rows = 200;
+  const std::size_t cols = 100;
+  const auto words = random_packed(generator, rows, cols, 32);
+  const temp_file file(words);
+
+  const auto expected =
+      find_max_square_packed({words.data(), rows, 2}, cols);
+  require_same(find_max_square_packed(file.path(), cols), expected);
+  require_same(find_max_square_packed(file.path(), cols, par), expected);
+  REQUIRE_THROWS_AS(find_max_square_packed(file.path(), 130),
+                    std::invalid_argument);
+}
+
+TEST_CASE("max_square_packed_invalid", "[max_square_packed]") {
+  const std::vector<std::uint64_t> words(4, 0);
+  REQUIRE_THROWS_AS(find_max_square_packed({words.data(), 4, 1}, 65),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      find_max_square_packed("/nonexistent/max_square.bin", 64),
+      std::system_error);
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/arrays.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+using namespace mse;
+
+namespace {
+// Selects every n in turn and checks the result against a sorted copy.
+template <typename T, typename Compare = std::less<>>
+void require_selected(const std::vector<T> &input, Compare compare = {}) {
+  std::vector<T> sorted = input;
+  std::sort(sorted.begin(), sorted.end(), compare);
+
+  const std::size_t step = std::max<std::size_t>(1, input.size() / 50);
+  for (std::size_t n = 0; n < input.size(); n += step) {
+    std::vector<T> output = input;
+    nth_element(std::span<T>(output), n, compare);
+    REQUIRE(output[n] == sorted[n]);
+    for (std::size_t i = 0; i < n; i++)
+      REQUIRE(!compare(output[n], output[i]));
+    for (std::size_t i = n + 1; i < output.size(); i++)
+      REQUIRE(!compare(output[i], output[n]));
+  }
+}
+
+std::vector<std::int32_t> random_elements(std::size_t size,
+                                          std::int32_t modulo) {
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<std::int32_t> distribution(0, modulo - 1);
+  std::vector<std::int32_t> elements(size);
+  for (auto &element : elements)
+    element = distribution(generator);
+  return elements;
+}
+
+// McIlroy's adversary for quicksort-like algorithms: element values are fixed
+// lazily, during comparisons, so that every pivot turns out to be as bad as
+// possible.
+class adversary {
+public:
+  explicit adversary(std::size_t size)
+      : values_(size, static_cast<std::int32_t>(size)),
+        gas_(static_cast<std::int32_t>(size)) {}
+
+  bool operator()(std::uint32_t x, std::uint32_t y) {
+    comparisons_++;
+    if (values_[x] == gas_ && values_[y] == gas_)
+      values_[x == candidate_ ? x : y] = solid_++;
+    if (values_[x] == gas_)
+      candidate_ = x;
+    else if (values_[y] == gas_)
+      candidate_ = y;
+    return values_[x] < values_[y];
+  }
+
+  [[nodiscard]] std::size_t comparisons() const { return comparisons_; }
+
+private:
+  std::vector<std::int32_t> values_;
+  std::int32_t gas_;
+  std::int32_t solid_ = 0;
+  std::uint32_t candidate_ = 0;
+  std::size_t comparisons_ = 0;
+};
+} // namespace
+
+TEST_CASE("nth_element_single_element", "[nth_element]") {
+  std::vector<std::int32_t> input = {5};
+  nth_element(std::span<std::int32_t>(input), 0);
+  REQUIRE(input == std::vector<std::int32_t>{5});
+}
+
+TEST_CASE("nth_element_out_of_range", "[nth_element]") {
+  std::vector<std::int32_t> input = {1, 2};
+  REQUIRE_THROWS_AS(nth_element(std::span<std::int32_t>(input), 2),
+                    std::out_of_range);
+}
+
+TEST_CASE("nth_element_small_sizes", "[nth_element]") {
+  for (std::size_t size = 1; size < 100; size++)
+    require_selected(random_elements(size, 10));
+}
+
+TEST_CASE("nth_element_random", "[nth_element]") {
+  require_selected(random_elements(100000, 1 << 30));
+}
+
+TEST_CASE("nth_element_few_distinct", "[nth_element]") {
+  require_selected(random_elements(100000, 3));
+}
+
+TEST_CASE("nth_element_sorted_and_reversed", "[nth_element]") {
+  std::vector<std::int32_t> input(100000);
+  std::iota(input.begin(), input.end(), 0);
+  require_selected(input);
+  std::reverse(input.begin(), input.end());
+  require_selected(input);
+}
+
+TEST_CASE("nth_element_organ_pipe", "[nth_element]") {
+  std::vector<std::int32_t> input(100000);
+  for (std::int32_t i = 0; i < 100000; i++)
+    input[i] = std::min(i, 100000 - i);
+  require_selected(input);
+}
+
+TEST_CASE("nth_element_descending_doubles", "[nth_element]") {
+  std::vector<double> input(1000);
+  std::iota(input.begin(), input.end(), 0.25);
+  std::shuffle(input.begin(), input.end(), std::mt19937(3));
+  require_selected(input, std::greater<>());
+}
+
+TEST_CASE("nth_element_linear_against_adversary", "[nth_element]") {
+  const std::size_t size = 1 << 16;
+  adversary compare(size);
+  std::vector<std::uint32_t> input(size);
+  std::iota(input.begin(), input.end(), 0u);
+
+  nth_element(std::span<std::uint32_t>(input), size / 2,
+              [&compare](std::uint32_t x, std::uint32_t y) {
+                return compare(x, y);
+              });
+  // A quadratic quickselect would need about size^2 / 4 comparisons.
+  REQUIRE(compare.comparisons() < 40 * size);
+}
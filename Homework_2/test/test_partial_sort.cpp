@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/arrays.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+using namespace mse;
+
+namespace {
+std::vector<std::int32_t> random_elements(std::size_t size,
+                                          std::int32_t modulo) {
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<std::int32_t> distribution(0, modulo - 1);
+  std::vector<std::int32_t> elements(size);
+  for (auto &element : elements)
+    element = distribution(generator);
+  return elements;
+}
+} // namespace
+
+TEST_CASE("partial_sort_empty", "[partial_sort]") {
+  std::vector<std::int32_t> input;
+  partial_sort(std::span<std::int32_t>(input), 0);
+  REQUIRE(input.empty());
+}
+
+TEST_CASE("partial_sort_k_out_of_range", "[partial_sort]") {
+  std::vector<std::int32_t> input = {1, 2};
+  REQUIRE_THROWS_AS(partial_sort(std::span<std::int32_t>(input), 3),
+                    std::out_of_range);
+}
+
+TEST_CASE("partial_sort_small", "[partial_sort]") {
+  const std::vector<std::int32_t> original = {5, -1, 4, 0, 3, 2};
+  std::vector<std::int32_t> input = original;
+  partial_sort(std::span<std::int32_t>(input), 3);
+  REQUIRE(std::vector<std::int32_t>(input.begin(), input.begin() + 3) ==
+          std::vector<std::int32_t>{-1, 0, 2});
+  REQUIRE(std::is_permutation(input.begin(), input.end(), original.begin()));
+}
+
+TEST_CASE("partial_sort_all_k", "[partial_sort]") {
+  for (std::int32_t modulo : {4, 1 << 20}) {
+    const std::vector<std::int32_t> input = random_elements(3000, modulo);
+    std::vector<std::int32_t> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (std::size_t k : {0, 1, 2, 100, 1499, 2999, 3000}) {
+      std::vector<std::int32_t> output = input;
+      partial_sort(std::span<std::int32_t>(output), k);
+      REQUIRE(std::equal(output.begin(), output.begin() + k, sorted.begin()));
+      std::sort(output.begin() + k, output.end());
+      REQUIRE(output == sorted);
+    }
+  }
+}
+
+TEST_CASE("partial_sort_descending", "[partial_sort]") {
+  std::vector<std::int32_t> input = random_elements(10000, 1000);
+  std::vector<std::int32_t> sorted = input;
+  std::sort(sorted.begin(), sorted.end(), std::greater<>());
+  partial_sort(std::span<std::int32_t>(input), 10, std::greater<>());
+  REQUIRE(std::equal(input.begin(), input.begin() + 10, sorted.begin()));
+}
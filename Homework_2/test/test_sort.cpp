@@ -2,6 +2,15 @@
 
 #include <arrays/arrays.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+
 using namespace mse;
 
 TEST_CASE("sort_empty_array", "[sort]") {
@@ -59,3 +68,224 @@ TEST_CASE("sort_inv_sorted_element_array", "[sort]") {
   std::vector<std::int32_t> expected = {2, 3, 4, 5};
   REQUIRE(input == expected);
 }
+
+namespace {
+// Sorts input and checks the result against std::sort.
+void require_sorted(std::vector<std::int32_t> input) {
+  std::vector<std::int32_t> expected = input;
+  std::sort(expected.begin(), expected.end());
+  sort(input);
+  REQUIRE(input == expected);
+}
+
+std::vector<std::int32_t> random_elements(std::size_t size,
+                                          std::int32_t modulo) {
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<std::int32_t> distribution(0, modulo - 1);
+  std::vector<std::int32_t> elements(size);
+  for (auto &element : elements)
+    element = distribution(generator);
+  return elements;
+}
+
+constexpr std::int32_t big_size = 1000000;
+} // namespace
+
+TEST_CASE("sort_big_sorted_array", "[sort]") {
+  std::vector<std::int32_t> input(big_size);
+  std::iota(input.begin(), input.end(), -big_size / 2);
+  require_sorted(input);
+}
+
+TEST_CASE("sort_big_inv_sorted_array", "[sort]") {
+  std::vector<std::int32_t> input(big_size);
+  std::iota(input.rbegin(), input.rend(), -big_size / 2);
+  require_sorted(input);
+}
+
+TEST_CASE("sort_big_equal_element_array", "[sort]") {
+  require_sorted(std::vector<std::int32_t>(big_size, 7));
+}
+
+TEST_CASE("sort_big_organ_pipe_array", "[sort]") {
+  std::vector<std::int32_t> input(big_size);
+  for (std::int32_t i = 0; i < big_size; i++)
+    input[i] = std::min(i, big_size - 1 - i);
+  require_sorted(input);
+}
+
+TEST_CASE("sort_big_sawtooth_array", "[sort]") {
+  std::vector<std::int32_t> input(big_size);
+  for (std::int32_t i = 0; i < big_size; i++)
+    input[i] = i % 1000;
+  require_sorted(input);
+}
+
+TEST_CASE("sort_big_few_distinct_element_array", "[sort]") {
+  require_sorted(random_elements(big_size, 4));
+}
+
+TEST_CASE("sort_big_random_array", "[sort]") {
+  require_sorted(
+      random_elements(big_size, std::numeric_limits<std::int32_t>::max()));
+}
+
+TEST_CASE("sort_big_sorted_with_noise_array", "[sort]") {
+  std::vector<std::int32_t> input(big_size);
+  std::iota(input.begin(), input.end(), 0);
+  for (std::int32_t i = 0; i < big_size; i += 997)
+    input[i] = -i;
+  require_sorted(input);
+}
+
+TEST_CASE("sort_extreme_element_array", "[sort]") {
+  const std::int32_t min = std::numeric_limits<std::int32_t>::min();
+  const std::int32_t max = std::numeric_limits<std::int32_t>::max();
+  require_sorted({max, min, 0, -1, max, min, 1, max, min});
+}
+
+TEST_CASE("sort_all_small_sizes", "[sort]") {
+  for (std::size_t size = 0; size < 300; size++) {
+    require_sorted(random_elements(size, 50));
+    require_sorted(random_elements(size, 1 << 20));
+  }
+}
+
+TEST_CASE("sort_big_narrow_range_array", "[sort]") {
+  // Only the lowest radix digit varies, so the other passes are skipped.
+  require_sorted(random_elements(big_size, 1 << 11));
+}
+
+TEST_CASE("sort_big_negative_array", "[sort]") {
+  std::vector<std::int32_t> input = random_elements(big_size, 1 << 30);
+  for (auto &element : input)
+    element = -element - 1;
+  require_sorted(input);
+}
+
+TEST_CASE("sort_around_radix_threshold", "[sort]") {
+  for (std::size_t size = 4080; size < 4110; size++)
+    require_sorted(
+        random_elements(size, std::numeric_limits<std::int32_t>::max()));
+}
+
+namespace {
+void require_parallel_sorted(std::vector<std::int32_t> input,
+                             unsigned threads) {
+  std::vector<std::int32_t> expected = input;
+  std::sort(expected.begin(), expected.end());
+  sort(input, parallel_policy{threads});
+  REQUIRE(input == expected);
+}
+} // namespace
+
+TEST_CASE("sort_parallel_small_array", "[sort]") {
+  require_parallel_sorted({3, -1, 2, 0}, 4);
+  require_parallel_sorted({}, 4);
+}
+
+TEST_CASE("sort_parallel_random_array", "[sort]") {
+  for (unsigned threads : {1u, 2u, 3u, 4u, 7u}) {
+    require_parallel_sorted(
+        random_elements(big_size, std::numeric_limits<std::int32_t>::max()),
+        threads);
+  }
+}
+
+TEST_CASE("sort_parallel_few_distinct_element_array", "[sort]") {
+  require_parallel_sorted(random_elements(big_size, 3), 4);
+}
+
+TEST_CASE("sort_parallel_inv_sorted_array", "[sort]") {
+  std::vector<std::int32_t> input(big_size);
+  std::iota(input.rbegin(), input.rend(), -big_size / 2);
+  require_parallel_sorted(input, 4);
+}
+
+TEST_CASE("sort_parallel_default_threads", "[sort]") {
+  std::vector<std::int32_t> input =
+      random_elements(big_size, std::numeric_limits<std::int32_t>::max());
+  std::vector<std::int32_t> expected = input;
+  std::sort(expected.begin(), expected.end());
+  sort(input, par);
+  REQUIRE(input == expected);
+}
+
+TEST_CASE("sort_span_descending", "[sort]") {
+  std::vector<std::int32_t> input = random_elements(1000, 100);
+  std::vector<std::int32_t> expected = input;
+  std::sort(expected.begin(), expected.end(), std::greater<>());
+  sort(std::span<std::int32_t>(input), std::greater<>());
+  REQUIRE(input == expected);
+}
+
+TEST_CASE("sort_span_int32_ascending", "[sort]") {
+  std::vector<std::int32_t> input = random_elements(big_size, 1 << 30);
+  std::vector<std::int32_t> expected = input;
+  std::sort(expected.begin(), expected.end());
+  sort(std::span<std::int32_t>(input));
+  REQUIRE(input == expected);
+}
+
+TEST_CASE("sort_span_int32_adversarial_patterns", "[sort]") {
+  // A comparator other than std::less<> keeps int32 off the radix path, so
+  // large adversarial inputs still go through introsort.
+  const auto less = [](std::int32_t a, std::int32_t b) { return a < b; };
+  std::vector<std::vector<std::int32_t>> inputs;
+  inputs.emplace_back(big_size);
+  std::iota(inputs.back().begin(), inputs.back().end(), -big_size / 2);
+  inputs.emplace_back(big_size);
+  std::iota(inputs.back().rbegin(), inputs.back().rend(), -big_size / 2);
+  inputs.emplace_back(big_size, 7);
+  inputs.emplace_back(big_size);
+  for (std::int32_t i = 0; i < big_size; i++)
+    inputs.back()[i] = std::min(i, big_size - 1 - i);
+  inputs.emplace_back(big_size);
+  for (std::int32_t i = 0; i < big_size; i++)
+    inputs.back()[i] = i % 1000;
+  inputs.push_back(random_elements(big_size, 4));
+  inputs.emplace_back(big_size);
+  std::iota(inputs.back().begin(), inputs.back().end(), 0);
+  for (std::int32_t i = 0; i < big_size; i += 997)
+    inputs.back()[i] = -i;
+
+  for (auto &input : inputs) {
+    std::vector<std::int32_t> expected = input;
+    std::sort(expected.begin(), expected.end());
+    sort(std::span<std::int32_t>(input), less);
+    REQUIRE(input == expected);
+  }
+}
+
+TEST_CASE("sort_span_strings", "[sort]") {
+  std::vector<std::string> input = {"pear", "apple", "fig", "banana", "apple",
+                                    "cherry", "", "date"};
+  std::vector<std::string> expected = input;
+  std::sort(expected.begin(), expected.end());
+  sort(std::span<std::string>(input));
+  REQUIRE(input == expected);
+}
+
+TEST_CASE("sort_span_doubles_adversarial", "[sort]") {
+  for (std::size_t size : {0, 1, 23, 24, 129, 10000}) {
+    std::vector<double> sorted(size);
+    std::iota(sorted.begin(), sorted.end(), 0.5);
+    std::vector<double> reversed(sorted.rbegin(), sorted.rend());
+    std::vector<double> equal(size, 1.0);
+
+    sort(std::span<double>(reversed));
+    REQUIRE(reversed == sorted);
+    sort(std::span<double>(equal));
+    REQUIRE(equal == std::vector<double>(size, 1.0));
+  }
+}
+
+TEST_CASE("sort_span_move_only", "[sort]") {
+  std::vector<std::unique_ptr<std::int32_t>> input;
+  for (std::int32_t value : random_elements(500, 50))
+    input.push_back(std::make_unique<std::int32_t>(value));
+  sort(std::span<std::unique_ptr<std::int32_t>>(input),
+       [](const auto &a, const auto &b) { return *a < *b; });
+  REQUIRE(std::is_sorted(input.begin(), input.end(),
+                         [](const auto &a, const auto &b) { return *a < *b; }));
+}
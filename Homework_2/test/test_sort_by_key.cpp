@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/arrays.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace mse;
+
+TEST_CASE("sort_by_key_empty", "[sort_by_key]") {
+  std::vector<std::int32_t> keys;
+  std::vector<std::string> values;
+  sort_by_key(std::span<std::int32_t>(keys), std::span<std::string>(values));
+  REQUIRE(keys.empty());
+  REQUIRE(values.empty());
+}
+
+TEST_CASE("sort_by_key_small", "[sort_by_key]") {
+  std::vector<std::int32_t> keys = {3, 1, 2};
+  std::vector<std::string> values = {"three", "one", "two"};
+  sort_by_key(std::span<std::int32_t>(keys), std::span<std::string>(values));
+  REQUIRE(keys == std::vector<std::int32_t>{1, 2, 3});
+  REQUIRE(values == std::vector<std::string>{"one", "two", "three"});
+}
+
+TEST_CASE("sort_by_key_descending", "[sort_by_key]") {
+  std::vector<double> keys = {0.5, 2.5, 1.5};
+  std::vector<char> values = {'a', 'c', 'b'};
+  sort_by_key(std::span<double>(keys), std::span<char>(values),
+              std::greater<>());
+  REQUIRE(keys == std::vector<double>{2.5, 1.5, 0.5});
+  REQUIRE(values == std::vector<char>{'c', 'b', 'a'});
+}
+
+TEST_CASE("sort_by_key_keeps_pairs_together", "[sort_by_key]") {
+  std::mt19937 generator(5);
+  std::uniform_int_distribution<std::int32_t> distribution(-100, 100);
+  for (std::size_t size : {10, 100, 10000, 100000}) {
+    std::vector<std::int32_t> keys(size);
+    std::vector<std::uint64_t> values(size);
+    std::vector<std::pair<std::int32_t, std::uint64_t>> pairs(size);
+    for (std::size_t i = 0; i < size; i++) {
+      keys[i] = distribution(generator);
+      values[i] = i;
+      pairs[i] = {keys[i], values[i]};
+    }
+
+    sort_by_key(std::span<std::int32_t>(keys),
+                std::span<std::uint64_t>(values));
+
+    REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+    std::vector<std::pair<std::int32_t, std::uint64_t>> result(size);
+    for (std::size_t i = 0; i < size; i++) {
+      REQUIRE(keys[i] == pairs[values[i]].first);
+      result[i] = {keys[i], values[i]};
+    }
+    std::sort(result.begin(), result.end());
+    std::sort(pairs.begin(), pairs.end());
+    REQUIRE(result == pairs);
+  }
+}
+
+TEST_CASE("sort_by_key_size_mismatch", "[sort_by_key]") {
+  std::vector<std::int32_t> keys = {1, 2};
+  std::vector<std::int32_t> values = {1};
+  REQUIRE_THROWS_AS(sort_by_key(std::span<std::int32_t>(keys),
+                                std::span<std::int32_t>(values)),
+                    std::invalid_argument);
+}
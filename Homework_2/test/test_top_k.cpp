@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arrays/arrays.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+
+using namespace mse;
+
+TEST_CASE("top_k_small", "[top_k]") {
+  std::vector<std::int32_t> input = {4, 9, -2, 9, 7, 0};
+  const auto res = top_k(std::span<const std::int32_t>(input), 3);
+  REQUIRE(res == std::vector<std::int32_t>{9, 9, 7});
+}
+
+TEST_CASE("top_k_more_than_size", "[top_k]") {
+  std::vector<std::int32_t> input = {1, 3, 2};
+  const auto res = top_k(std::span<const std::int32_t>(input), 10);
+  REQUIRE(res == std::vector<std::int32_t>{3, 2, 1});
+}
+
+TEST_CASE("top_k_zero", "[top_k]") {
+  std::vector<std::int32_t> input = {1, 3, 2};
+  REQUIRE(top_k(std::span<const std::int32_t>(input), 0).empty());
+}
+
+TEST_CASE("top_k_smallest_strings", "[top_k]") {
+  std::vector<std::string> input = {"d", "a", "c", "b"};
+  const auto res =
+      top_k(std::span<const std::string>(input), 2, std::greater<>());
+  REQUIRE(res == std::vector<std::string>{"a", "b"});
+}
+
+TEST_CASE("top_k_stream_matches_top_k", "[top_k]") {
+  std::mt19937 generator(17);
+  std::uniform_int_distribution<std::int32_t> distribution(-1000000, 1000000);
+  std::vector<std::int32_t> input(200000);
+  for (auto &element : input)
+    element = distribution(generator);
+
+  for (std::size_t k : {0, 1, 10, 1000}) {
+    top_k_stream<std::int32_t> stream(k);
+    for (const std::int32_t element : input)
+      stream.push(element);
+    REQUIRE(stream.result() == top_k(std::span<const std::int32_t>(input), k));
+  }
+}
+
+TEST_CASE("top_k_stream_fewer_than_k", "[top_k]") {
+  top_k_stream<std::string> stream(5);
+  stream.push("b");
+  stream.push("c");
+  stream.push("a");
+  REQUIRE(stream.result() == std::vector<std::string>{"c", "b", "a"});
+}
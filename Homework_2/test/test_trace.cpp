@@ -2,6 +2,8 @@
 
 #include <arrays/arrays.h>
 
+#include <limits>
+
 using namespace mse;
 
 TEST_CASE("trace_empty_matrix", "[trace]") {
@@ -55,3 +57,47 @@ TEST_CASE("trace_matrix_100x100", "[trace]") {
   const auto res = trace(input);
   REQUIRE(res == size * (size - 1));
 }
+
+TEST_CASE("trace_view_flat_buffer", "[trace]") {
+  const std::vector<std::int32_t> buffer = {
+      -1, 1,  1,  //
+      -1, 10, 1,  //
+      5,  1,  -2, //
+  };
+  const auto res = trace(matrix_view<const std::int32_t>(buffer.data(), 3, 3));
+  REQUIRE(res == 7);
+}
+
+TEST_CASE("trace_view_submatrix", "[trace]") {
+  constexpr std::size_t size = 10;
+  std::vector<std::int32_t> buffer(size * size);
+  for (std::size_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = static_cast<std::int32_t>(i);
+
+  const matrix_view<std::int32_t> matrix(buffer.data(), size, size);
+  // Elements (2, 3), (3, 4), (4, 5) and (5, 6).
+  const auto res = trace(matrix.submatrix(2, 3, 4, 7));
+  REQUIRE(res == 23 + 34 + 45 + 56);
+}
+
+TEST_CASE("trace_view_no_overflow", "[trace]") {
+  constexpr std::size_t size = 4;
+  const std::vector<std::int32_t> buffer(
+      size * size, std::numeric_limits<std::int32_t>::max());
+  const auto res =
+      trace(matrix_view<const std::int32_t>(buffer.data(), size, size));
+  REQUIRE(res == std::int64_t{4} * std::numeric_limits<std::int32_t>::max());
+}
+
+TEST_CASE("trace_overflow_throws", "[trace]") {
+  const auto max = std::numeric_limits<std::int32_t>::max();
+  const std::vector<std::vector<std::int32_t>> input = {{max, 0}, {0, 1}};
+  REQUIRE_THROWS_AS(trace(input), std::overflow_error);
+}
+
+TEST_CASE("trace_extremes_fit", "[trace]") {
+  const auto max = std::numeric_limits<std::int32_t>::max();
+  const auto min = std::numeric_limits<std::int32_t>::min();
+  const std::vector<std::vector<std::int32_t>> input = {{max, 0}, {0, min}};
+  REQUIRE(trace(input) == -1);
+}
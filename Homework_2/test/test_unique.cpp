@@ -2,6 +2,10 @@
 
 #include <arrays/arrays.h>
 
+#include <algorithm>
+#include <limits>
+#include <random>
+
 using namespace mse;
 
 TEST_CASE("unique_positive_only_element_array", "[unique]") {
@@ -27,3 +31,76 @@ TEST_CASE("unique_single_element_array", "[unique]") {
   const auto res = find_unique_element(input);
   REQUIRE(res == 1);
 }
+
+TEST_CASE("unique_no_unique_element_array", "[unique]") {
+  std::vector<std::int32_t> input = {4, 2, 4, 2};
+  const auto res = find_unique_element(input);
+  REQUIRE(res == -1);
+}
+
+TEST_CASE("unique_empty_array", "[unique]") {
+  std::vector<std::int32_t> input;
+  const auto res = find_unique_element(input);
+  REQUIRE(res == -1);
+}
+
+TEST_CASE("unique_first_in_order", "[unique]") {
+  std::vector<std::int32_t> input = {7, 3, 9, 7, 5};
+  const auto res = find_unique_element(input);
+  REQUIRE(res == 3);
+}
+
+TEST_CASE("unique_extreme_values", "[unique]") {
+  const std::int32_t min = std::numeric_limits<std::int32_t>::min();
+  const std::int32_t max = std::numeric_limits<std::int32_t>::max();
+  std::vector<std::int32_t> input = {min, 0, max, 0, min};
+  const auto res = find_unique_element(input);
+  REQUIRE(res == max);
+}
+
+namespace {
+// Every value 2147 * i + 1 for i in [0, size / 2) twice, shuffled, with
+// unique inserted at position.
+std::vector<std::int32_t> big_pairs(std::int32_t size, std::int32_t unique,
+                                    std::size_t position) {
+  std::vector<std::int32_t> elements;
+  for (std::int32_t value = 0; value < size / 2; value++) {
+    elements.push_back(value * 2147 + 1);
+    elements.push_back(value * 2147 + 1);
+  }
+  std::shuffle(elements.begin(), elements.end(), std::mt19937(size));
+  elements.insert(elements.begin() + static_cast<std::ptrdiff_t>(position),
+                  unique);
+  return elements;
+}
+} // namespace
+
+TEST_CASE("unique_big_array", "[unique]") {
+  const auto input = big_pairs(1000000, -5, 777777);
+  REQUIRE(find_unique_element(input) == -5);
+}
+
+TEST_CASE("unique_big_array_two_uniques", "[unique]") {
+  auto input = big_pairs(1000000, -5, 900000);
+  input.insert(input.begin() + 300000, -8);
+  REQUIRE(find_unique_element(input) == -8);
+}
+
+TEST_CASE("unique_pairs_tag", "[unique]") {
+  std::vector<std::int32_t> input = {-5, 1, -3, -3, 8, -5, 10, 8, 1};
+  REQUIRE(find_unique_element(input, pairs) == 10);
+  REQUIRE(find_unique_element(big_pairs(1000000, 0, 5), pairs) == 0);
+  REQUIRE(find_unique_element(std::vector<std::int32_t>{1, 1}, pairs) == -1);
+}
+
+TEST_CASE("unique_parallel", "[unique]") {
+  for (unsigned threads : {1u, 2u, 3u, 8u}) {
+    auto input = big_pairs(1000000, 42, 999000);
+    REQUIRE(find_unique_element(input, parallel_policy{threads}) == 42);
+    input.insert(input.begin() + 10, 43);
+    REQUIRE(find_unique_element(input, parallel_policy{threads}) == 43);
+  }
+  REQUIRE(find_unique_element(big_pairs(1000000, 0, 0), par) == 0);
+  REQUIRE(find_unique_element(std::vector<std::int32_t>(1000000, 3), par) ==
+          -1);
+}
@@ -0,0 +1,71 @@
+#include "chain.h"
+
+#include <limits>
+
+namespace mse {
+
+namespace {
+double product_flops(std::size_t rows, std::size_t inner, std::size_t cols) {
+    return 2.0 * static_cast<double>(rows) * static_cast<double>(inner) *
+           static_cast<double>(cols);
+}
+
+Matrix multiply_range(const ChainOrder &order, std::size_t first, std::size_t last,
+                      const std::function<Matrix(std::size_t)> &load,
+                      const std::function<Matrix(const Matrix &, const Matrix &)> &mult) {
+    if (first == last) {
+        return load(first);
+    }
+
+    const std::size_t split = order.split[first][last];
+    const Matrix left = multiply_range(order, first, split, load, mult);
+    const Matrix right = multiply_range(order, split + 1, last, load, mult);
+    return mult(left, right);
+}
+} // namespace
+
+ChainOrder optimal_chain_order(const std::vector<Shape> &shapes) {
+    const std::size_t n = shapes.size();
+    ChainOrder order;
+    order.split.assign(n, std::vector<std::size_t>(n, 0));
+
+    // flops[i][j]: the fewest operations for M_i ... M_j, by increasing j - i.
+    std::vector<std::vector<double>> flops(n, std::vector<double>(n, 0));
+    for (std::size_t length = 2; length <= n; length++) {
+        for (std::size_t i = 0; i + length <= n; i++) {
+            const std::size_t j = i + length - 1;
+            flops[i][j] = std::numeric_limits<double>::infinity();
+
+            for (std::size_t s = i; s < j; s++) {
+                const double cost = flops[i][s] + flops[s + 1][j] +
+                    product_flops(shapes[i].rows, shapes[s].cols, shapes[j].cols);
+                if (cost < flops[i][j]) {
+                    flops[i][j] = cost;
+                    order.split[i][j] = s;
+                }
+            }
+        }
+    }
+
+    order.flops = n == 0 ? 0 : flops[0][n - 1];
+    return order;
+}
+
+double left_to_right_flops(const std::vector<Shape> &shapes) {
+    double flops = 0;
+    for (std::size_t i = 1; i < shapes.size(); i++) {
+        flops += product_flops(shapes[0].rows, shapes[i].rows, shapes[i].cols);
+    }
+    return flops;
+}
+
+Matrix multiply_chain(std::size_t count, const ChainOrder &order,
+                      const std::function<Matrix(std::size_t)> &load,
+                      const std::function<Matrix(const Matrix &, const Matrix &)> &mult) {
+    if (count == 0) {
+        return {};
+    }
+    return multiply_range(order, 0, count - 1, load, mult);
+}
+
+} // namespace mse
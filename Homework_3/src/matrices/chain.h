@@ -0,0 +1,40 @@
+#pragma once
+
+#include "matrix.h"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace mse {
+
+struct Shape {
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+};
+
+// An order of evaluation of a chain product M_0 M_1 ... M_{n-1}.
+struct ChainOrder {
+    // The product of M_i ... M_j, i < j, is (M_i ... M_s) (M_{s+1} ... M_j)
+    // with s = split[i][j].
+    std::vector<std::vector<std::size_t>> split;
+    // Floating-point operations of the order: 2 m k n per m x k by k x n
+    // product.
+    double flops = 0;
+};
+
+// The order with the fewest floating-point operations for matrices of the
+// given shapes, which must chain, by the O(n^3) dynamic program.
+ChainOrder optimal_chain_order(const std::vector<Shape> &shapes);
+
+// Floating-point operations of evaluating the chain left to right.
+double left_to_right_flops(const std::vector<Shape> &shapes);
+
+// The product of count matrices in the given order, each product computed by
+// mult. Matrix i is taken from load(i) only when the evaluation reaches it,
+// so operands are not held in memory before their first product.
+Matrix multiply_chain(std::size_t count, const ChainOrder &order,
+                      const std::function<Matrix(std::size_t)> &load,
+                      const std::function<Matrix(const Matrix &, const Matrix &)> &mult);
+
+} // namespace mse
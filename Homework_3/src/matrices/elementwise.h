@@ -0,0 +1,40 @@
+#pragma once
+
+#include "matrix.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+namespace mse {
+
+// Bands of rows per thread in elementwise, so that threads that finish early
+// take more.
+inline constexpr std::size_t bands_per_thread = 4;
+
+// out(i, j) = op(x(i, j), y(i, j)), over bands of rows spread over the pool.
+// The shapes must match; out may be x or y.
+template <typename Op>
+void elementwise(MatrixView out, ConstMatrixView x, ConstMatrixView y, Op op,
+                 ThreadPool &pool) {
+    const std::size_t rows = out.rows();
+    const std::size_t bands = std::min(rows, pool.size() * bands_per_thread);
+    const std::size_t band_rows = bands == 0 ? 0 : (rows + bands - 1) / bands;
+
+    pool.parallel_for(bands, [&](std::size_t band) {
+        const std::size_t band_end = std::min(rows, (band + 1) * band_rows);
+
+        for (std::size_t i = band * band_rows; i < band_end; i++) {
+            const std::span<double> out_row = out.row(i);
+            const std::span<const double> x_row = x.row(i);
+            const std::span<const double> y_row = y.row(i);
+
+            for (std::size_t j = 0; j < out_row.size(); j++) {
+                out_row[j] = op(x_row[j], y_row[j]);
+            }
+        }
+    });
+}
+
+} // namespace mse
@@ -0,0 +1,220 @@
+#include "gemm.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace mse {
+
+namespace {
+// The micro-kernel computes a block of kernel_rows x kernel_cols elements of c,
+// held in registers: 12 AVX2 accumulators.
+constexpr std::size_t kernel_rows = 6;
+constexpr std::size_t kernel_cols = 8;
+
+// Blocks of a and b are packed so that a panel of block_rows x block_depth
+// elements of a stays in L2 and one of block_depth x block_cols elements of b
+// in L3, while the micro-kernel streams through L1.
+constexpr std::size_t block_rows = 72;
+constexpr std::size_t block_depth = 256;
+constexpr std::size_t block_cols = 4080;
+
+// Tiles of c per thread, so that threads that finish early take more.
+constexpr std::size_t tasks_per_thread = 4;
+
+// Packs the rows of a into slivers of kernel_rows rows, one per row of packed:
+// for every k, the kernel_rows elements of column k. Missing rows are zero.
+void pack_a(ConstMatrixView a, Matrix &packed) {
+    for (std::size_t sliver = 0; sliver * kernel_rows < a.rows(); sliver++) {
+        double *to = packed.row(sliver).data();
+        const std::size_t first = sliver * kernel_rows;
+        const std::size_t rows = std::min(kernel_rows, a.rows() - first);
+
+        for (std::size_t k = 0; k < a.cols(); k++) {
+            for (std::size_t r = 0; r < rows; r++) {
+                to[r] = a(first + r, k);
+            }
+            std::fill(to + rows, to + kernel_rows, 0.0);
+            to += kernel_rows;
+        }
+    }
+}
+
+// Packs the columns of b into slivers of kernel_cols columns, one per row of
+// packed: for every k, the kernel_cols elements of row k. Missing columns are
+// zero.
+void pack_b(ConstMatrixView b, Matrix &packed) {
+    for (std::size_t sliver = 0; sliver * kernel_cols < b.cols(); sliver++) {
+        double *to = packed.row(sliver).data();
+        const std::size_t first = sliver * kernel_cols;
+        const std::size_t cols = std::min(kernel_cols, b.cols() - first);
+
+        for (std::size_t k = 0; k < b.rows(); k++) {
+            const double *from = b.row(k).data() + first;
+            std::copy(from, from + cols, to);
+            std::fill(to + cols, to + kernel_cols, 0.0);
+            to += kernel_cols;
+        }
+    }
+}
+
+// c[r * stride + j] += sum over k of a[k * kernel_rows + r] * b[k * kernel_cols + j]
+// for a whole kernel_rows x kernel_cols block.
+using micro_kernel = void (*)(std::size_t depth, const double *a, const double *b,
+                              double *c, std::size_t stride);
+
+void micro_kernel_portable(std::size_t depth, const double *a, const double *b,
+                           double *c, std::size_t stride) {
+    double sums[kernel_rows][kernel_cols] = {};
+    for (std::size_t k = 0; k < depth; k++) {
+        for (std::size_t r = 0; r < kernel_rows; r++) {
+            for (std::size_t j = 0; j < kernel_cols; j++) {
+                sums[r][j] += a[r] * b[j];
+            }
+        }
+        a += kernel_rows;
+        b += kernel_cols;
+    }
+
+    for (std::size_t r = 0; r < kernel_rows; r++) {
+        for (std::size_t j = 0; j < kernel_cols; j++) {
+            c[r * stride + j] += sums[r][j];
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+[[gnu::target("avx2,fma")]] void micro_kernel_avx2(std::size_t depth, const double *a,
+                                                   const double *b, double *c,
+                                                   std::size_t stride) {
+    __m256d sums[kernel_rows][2];
+#pragma GCC unroll 6
+    for (std::size_t r = 0; r < kernel_rows; r++) {
+        sums[r][0] = _mm256_setzero_pd();
+        sums[r][1] = _mm256_setzero_pd();
+    }
+
+    for (std::size_t k = 0; k < depth; k++) {
+        const __m256d b_low = _mm256_load_pd(b);
+        const __m256d b_high = _mm256_load_pd(b + 4);
+#pragma GCC unroll 6
+        for (std::size_t r = 0; r < kernel_rows; r++) {
+            const __m256d a_element = _mm256_broadcast_sd(a + r);
+            sums[r][0] = _mm256_fmadd_pd(a_element, b_low, sums[r][0]);
+            sums[r][1] = _mm256_fmadd_pd(a_element, b_high, sums[r][1]);
+        }
+        a += kernel_rows;
+        b += kernel_cols;
+    }
+
+#pragma GCC unroll 6
+    for (std::size_t r = 0; r < kernel_rows; r++) {
+        double *row = c + r * stride;
+        _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), sums[r][0]));
+        _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), sums[r][1]));
+    }
+}
+
+micro_kernel select_micro_kernel() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return micro_kernel_avx2;
+    }
+    return micro_kernel_portable;
+}
+#else
+micro_kernel select_micro_kernel() {
+    return micro_kernel_portable;
+}
+#endif
+
+// c += a * b for packed blocks of a and b, kernel block by kernel block, the
+// columns of b starting from sliver first_sliver. Blocks of c cut by its edges
+// are computed into a scratch block first.
+void multiply_packed(const Matrix &packed_a, const Matrix &packed_b,
+                     std::size_t first_sliver, std::size_t depth, MatrixView c,
+                     micro_kernel kernel) {
+    for (std::size_t j = 0; j < c.cols(); j += kernel_cols) {
+        const double *b = packed_b.row(first_sliver + j / kernel_cols).data();
+        const std::size_t cols = std::min(kernel_cols, c.cols() - j);
+
+        for (std::size_t i = 0; i < c.rows(); i += kernel_rows) {
+            const double *a = packed_a.row(i / kernel_rows).data();
+            const std::size_t rows = std::min(kernel_rows, c.rows() - i);
+
+            if (rows == kernel_rows && cols == kernel_cols) {
+                kernel(depth, a, b, &c(i, j), c.stride());
+                continue;
+            }
+
+            double edge[kernel_rows * kernel_cols] = {};
+            kernel(depth, a, b, edge, kernel_cols);
+            for (std::size_t r = 0; r < rows; r++) {
+                for (std::size_t s = 0; s < cols; s++) {
+                    c(i + r, j + s) += edge[r * kernel_cols + s];
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+void gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c) {
+    ThreadPool pool(1);
+    gemm(a, b, c, pool);
+}
+
+void gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c, ThreadPool &pool) {
+    if (a.cols() != b.rows() || a.rows() != c.rows() || b.cols() != c.cols()) {
+        throw std::invalid_argument("Matrix sizes do not match each other.");
+    }
+    if (c.rows() == 0 || c.cols() == 0) {
+        return;
+    }
+
+    static const micro_kernel kernel = select_micro_kernel();
+
+    const std::size_t depth = std::min(block_depth, a.cols());
+    Matrix packed_b((std::min(block_cols, b.cols()) + kernel_cols - 1) / kernel_cols,
+                    depth * kernel_cols);
+
+    // Tiles of c are spread over the threads: every row block of a, packed
+    // by the thread that takes it, times a run of slivers of b. Every element
+    // of c sums the same products in the same order whatever the tiles, so
+    // the result does not depend on the number of threads.
+    const std::size_t row_blocks = (a.rows() + block_rows - 1) / block_rows;
+    const std::size_t tasks = pool.size() == 1 ? 1 : pool.size() * tasks_per_thread;
+    const std::size_t col_chunks_wanted = (tasks + row_blocks - 1) / row_blocks;
+
+    for (std::size_t jc = 0; jc < b.cols(); jc += block_cols) {
+        const std::size_t nc = std::min(block_cols, b.cols() - jc);
+        const std::size_t slivers = (nc + kernel_cols - 1) / kernel_cols;
+        const std::size_t chunk_slivers =
+            (slivers + col_chunks_wanted - 1) / col_chunks_wanted;
+        const std::size_t col_chunks = (slivers + chunk_slivers - 1) / chunk_slivers;
+
+        for (std::size_t pc = 0; pc < a.cols(); pc += block_depth) {
+            const std::size_t kc = std::min(block_depth, a.cols() - pc);
+            pack_b(b.submatrix(pc, jc, kc, nc), packed_b);
+
+            pool.parallel_for(row_blocks * col_chunks, [&](std::size_t tile) {
+                const std::size_t ic = tile / col_chunks * block_rows;
+                const std::size_t mc = std::min(block_rows, a.rows() - ic);
+                const std::size_t first_sliver = tile % col_chunks * chunk_slivers;
+                const std::size_t first_col = first_sliver * kernel_cols;
+                const std::size_t cols = std::min(chunk_slivers * kernel_cols, nc - first_col);
+
+                Matrix packed_a((mc + kernel_rows - 1) / kernel_rows, kc * kernel_rows);
+                pack_a(a.submatrix(ic, pc, mc, kc), packed_a);
+                multiply_packed(packed_a, packed_b, first_sliver, kc,
+                                c.submatrix(ic, jc + first_col, mc, cols), kernel);
+            });
+        }
+    }
+}
+
+} // namespace mse
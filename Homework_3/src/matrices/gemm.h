@@ -0,0 +1,18 @@
+#pragma once
+
+#include "matrix.h"
+#include "thread_pool.h"
+
+namespace mse {
+
+// c += a * b. The operands are packed into cache-sized panels and multiplied
+// by an AVX2/FMA micro-kernel when the CPU has it, by a portable one
+// otherwise. c must not overlap a or b. Throws std::invalid_argument if the
+// shapes do not match.
+void gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c);
+
+// Same, spread over the threads of pool. The result does not depend on the
+// number of threads.
+void gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c, ThreadPool &pool);
+
+} // namespace mse
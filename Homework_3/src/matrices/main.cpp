@@ -1,27 +1,123 @@
 #define ADD "--add"
 #define MULT "--mult"
+#define THREADS "--threads"
+#define ALGO "--algo"
+#define OPTIMIZE_CHAIN "--optimize-chain"
+#define CROSSOVER "--crossover"
+#define FULL_PRECISION "--full-precision"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <thread>
 #include <vector>
 #include "main.h"
+#include "elementwise.h"
+#include "gemm.h"
 
 namespace mse {
 
-void check_input_format(const int &argc, char** &argv) {
-    if (argc < 2) {
+namespace {
+// A positive number of at most 6 digits and at most limit; what names it in
+// the error.
+unsigned parse_count(const std::string &value, const std::string &what,
+                     unsigned limit = 999999) {
+    const bool digits = !value.empty() && value.size() <= 6 &&
+        std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; });
+    const unsigned count = digits ? std::stoul(value) : 0;
+
+    if (count == 0 || count > limit) {
+        throw std::invalid_argument("Incorrect " + what + ": " + value + ".");
+    }
+    return count;
+}
+
+// More threads than a few per hardware thread only add switching, and a
+// typo such as 999999 would otherwise start that many threads.
+unsigned parse_threads(const std::string &value) {
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    return parse_count(value, "number of threads", 4 * hardware);
+}
+
+MultAlgorithm parse_algorithm(const std::string &value) {
+    if (value == "auto") {
+        return MultAlgorithm::automatic;
+    }
+    if (value == "classic") {
+        return MultAlgorithm::classic;
+    }
+    if (value == "strassen") {
+        return MultAlgorithm::strassen;
+    }
+    throw std::invalid_argument(
+        "Incorrect algorithm: " + value + ". Available algorithms are: auto, classic, strassen.");
+}
+} // namespace
+
+Options parse_options(std::vector<std::string> &arguments) {
+    Options options;
+    std::vector<std::string> rest;
+
+    for (std::size_t i = 0; i < arguments.size(); i++) {
+        const std::string &argument = arguments[i];
+
+        if (argument == THREADS) {
+            if (i + 1 == arguments.size()) {
+                throw std::invalid_argument("Missing number of threads after --threads.");
+            }
+            options.threads = parse_threads(arguments[++i]);
+        } else if (argument.starts_with(THREADS "=")) {
+            options.threads = parse_threads(argument.substr(std::strlen(THREADS "=")));
+        } else if (argument == CROSSOVER) {
+            if (i + 1 == arguments.size()) {
+                throw std::invalid_argument("Missing size after --crossover.");
+            }
+            options.crossover = parse_count(arguments[++i], "crossover size");
+        } else if (argument.starts_with(CROSSOVER "=")) {
+            options.crossover =
+                parse_count(argument.substr(std::strlen(CROSSOVER "=")), "crossover size");
+        } else if (argument == OPTIMIZE_CHAIN) {
+            options.optimize_chain = true;
+        } else if (argument == FULL_PRECISION) {
+            options.full_precision = true;
+        } else if (argument == ALGO) {
+            if (i + 1 == arguments.size()) {
+                throw std::invalid_argument("Missing algorithm after --algo.");
+            }
+            options.algorithm = parse_algorithm(arguments[++i]);
+        } else if (argument.starts_with(ALGO "=")) {
+            options.algorithm = parse_algorithm(argument.substr(std::strlen(ALGO "=")));
+        } else {
+            rest.push_back(argument);
+        }
+    }
+
+    arguments = std::move(rest);
+    return options;
+}
+
+void check_input_format(const std::vector<std::string> &arguments) {
+    if (arguments.empty()) {
         throw std::invalid_argument("At least one parameter should be passed.");
     }
 
-    for (auto i = 2; i < argc; i+=2) {
-        if (strcmp(argv[i], ADD) != 0 && strcmp(argv[i], MULT) != 0) {
+    for (std::size_t i = 1; i < arguments.size(); i += 2) {
+        if (arguments[i] != ADD && arguments[i] != MULT) {
             throw std::invalid_argument(
-                "Incorrect parameter: " + std::string(argv[i]) +
-                ". Available parameters are: --add, --mult.");
+                "Incorrect parameter: " + arguments[i] +
+                ". Available parameters are: --add, --mult, --threads, --algo, --crossover, "
+                "--optimize-chain, --full-precision.");
         }
     }
+
+    if (arguments.size() % 2 == 0) {
+        throw std::invalid_argument("Missing matrix after " + arguments.back() + ".");
+    }
 }
 
 std::fstream open_file(const std::string &file_name) {
@@ -39,117 +135,191 @@ void close_file(std::fstream &file) {
   file.close();
 }
 
-std::vector<std::vector<double>> read_matrix(std::fstream &file) {
-    int n_rows = 0;
-    int n_cols = 0;
+Matrix read_matrix(std::fstream &file) {
+    std::size_t n_rows = 0;
+    std::size_t n_cols = 0;
     file >> n_rows >> n_cols;
 
-    std::vector<std::vector<double>> matrix(n_rows, std::vector<double>(n_cols));
+    Matrix matrix(n_rows, n_cols);
 
-    for (auto i = 0; i < n_rows; i++) {
-        for (auto j = 0; j < n_cols; j++) {
-            file >> matrix[i][j];
+    for (std::size_t i = 0; i < n_rows; i++) {
+        for (double &element : matrix.row(i)) {
+            file >> element;
         }
     }
 
     return matrix;
 }
 
-std::vector<std::vector<double>> get_matrix(const std::string &file_name) {
+Matrix get_matrix(const std::string &file_name) {
     std::fstream file = mse::open_file(file_name);
-    const std::vector<std::vector<double>> matrix = mse::read_matrix(file);
+    Matrix matrix = mse::read_matrix(file);
     mse::close_file(file);
 
     return matrix;
 }
 
-void check_add_shapes(const std::vector<std::vector<double>> &matrix_1,
-                      const std::vector<std::vector<double>> &matrix_2) {
-    if (matrix_1.size() != matrix_2.size() || matrix_1[0].size() != matrix_2[0].size()) {
+Shape get_shape(const std::string &file_name) {
+    std::fstream file = mse::open_file(file_name);
+    Shape shape;
+    file >> shape.rows >> shape.cols;
+    mse::close_file(file);
+
+    return shape;
+}
+
+void check_add_shapes(const Matrix &matrix_1, const Matrix &matrix_2) {
+    if (matrix_1.rows() != matrix_2.rows() || matrix_1.cols() != matrix_2.cols()) {
         throw std::invalid_argument("Matrix sizes do not match each other.");
     }
 }
 
-std::vector<std::vector<double>> add(const std::vector<std::vector<double>> &matrix_1,
-                                     const std::vector<std::vector<double>> &matrix_2) {
+Matrix add(const Matrix &matrix_1, const Matrix &matrix_2, ThreadPool &pool) {
     check_add_shapes(matrix_1, matrix_2);
 
-    const int n_rows = matrix_1.size();
-    const int n_cols = matrix_1[0].size();
-
-    std::vector<std::vector<double>> result_matrix(n_rows, std::vector<double>(n_cols));
-
-    for (auto i = 0; i < n_rows; ++i) {
-        for (auto j = 0; j < n_cols; ++j) {
-            result_matrix[i][j] = matrix_1[i][j] + matrix_2[i][j];
-        }
-    }
+    Matrix result_matrix(matrix_1.rows(), matrix_1.cols());
+    elementwise(result_matrix.view(), matrix_1.view(), matrix_2.view(), std::plus<>(), pool);
 
     return result_matrix;
 }
 
-void check_mult_shapes(const std::vector<std::vector<double>> &matrix_1,
-                       const std::vector<std::vector<double>> &matrix_2) {
-    if (matrix_1[0].size() != matrix_2.size()) {
+void check_mult_shapes(const Matrix &matrix_1, const Matrix &matrix_2) {
+    if (matrix_1.cols() != matrix_2.rows()) {
         throw std::invalid_argument("Matrix sizes do not match each other.");
     }
 }
 
-std::vector<std::vector<double>> mult(const std::vector<std::vector<double>> &matrix_1,
-                                      const std::vector<std::vector<double>> &matrix_2) {
+Matrix mult(const Matrix &matrix_1, const Matrix &matrix_2, ThreadPool &pool,
+            MultAlgorithm algorithm, std::size_t crossover) {
     check_mult_shapes(matrix_1, matrix_2);
 
-    const int n_rows = matrix_1.size();
-    const int n_cols = matrix_2[0].size();
-    const int inner_side = matrix_1[0].size();
+    Matrix result_matrix(matrix_1.rows(), matrix_2.cols());
+    switch (algorithm) {
+    case MultAlgorithm::automatic:
+        strassen(matrix_1.view(), matrix_2.view(), result_matrix.view(), pool, crossover);
+        break;
+    case MultAlgorithm::classic:
+        gemm(matrix_1.view(), matrix_2.view(), result_matrix.view(), pool);
+        break;
+    case MultAlgorithm::strassen:
+        strassen(matrix_1.view(), matrix_2.view(), result_matrix.view(), pool, crossover,
+                 true);
+        break;
+    }
 
-    std::vector<std::vector<double>> result_matrix(n_rows, std::vector<double>(n_cols));
+    return result_matrix;
+}
 
-    for (auto i = 0; i < n_rows; i++) {
-        for (auto j = 0; j < n_cols; j++) {
-            result_matrix[i][j] = 0;
+Matrix evaluate(const std::vector<std::string> &arguments, ThreadPool &pool,
+                const Options &options) {
+    Matrix result_matrix = get_matrix(arguments[0]);
 
-            for (auto k = 0; k < inner_side; k++) {
-                result_matrix[i][j] += matrix_1[i][k] * matrix_2[k][j];
-            }
+    for (std::size_t i = 1; i < arguments.size(); i += 2) {
+        const Matrix current_matrix = get_matrix(arguments[i + 1]);
+
+        if (arguments[i] == ADD) {
+            result_matrix = add(result_matrix, current_matrix, pool);
+        } else if (arguments[i] == MULT) {
+            result_matrix =
+                mult(result_matrix, current_matrix, pool, options.algorithm, options.crossover);
         }
     }
 
     return result_matrix;
 }
 
-void print_result(const std::vector<std::vector<double>> &result_matrix) {
-    const int n_rows = result_matrix.size();
-    const int n_cols = result_matrix[0].size();
-
-    std::cout << n_rows << " " << n_cols << std::endl;
+Matrix evaluate_optimized(const std::vector<std::string> &arguments, ThreadPool &pool,
+                          const Options &options) {
+    std::vector<Shape> shapes;
+    for (std::size_t i = 0; i < arguments.size(); i += 2) {
+        shapes.push_back(get_shape(arguments[i]));
+    }
 
-    for (auto i = 0; i < n_rows; ++i) {
-        for (auto j = 0; j < n_cols; ++j) {
-            std::cout << result_matrix[i][j] << " ";
+    Shape value = shapes[0];
+    for (std::size_t i = 1; i < arguments.size(); i += 2) {
+        const Shape &operand = shapes[(i + 1) / 2];
+        const bool match = arguments[i] == ADD
+            ? value.rows == operand.rows && value.cols == operand.cols
+            : value.cols == operand.rows;
+        if (!match) {
+            throw std::invalid_argument("Matrix sizes do not match each other.");
         }
-        std::cout << std::endl;
+        value.cols = operand.cols;
     }
-}
-} // namespace mse
 
+    double left_to_right = 0;
+    double optimized = 0;
+
+    // The value so far times the operands of a run of --mult. The order needs
+    // only the shapes; every operand is read when the order reaches it.
+    auto multiply_run = [&](Matrix value, const std::vector<std::size_t> &operands) {
+        std::vector<Shape> chain_shapes = {{value.rows(), value.cols()}};
+        for (const std::size_t operand : operands) {
+            chain_shapes.push_back(shapes[operand]);
+        }
+
+        const ChainOrder order = optimal_chain_order(chain_shapes);
+        left_to_right += left_to_right_flops(chain_shapes);
+        optimized += order.flops;
+
+        auto load = [&](std::size_t i) {
+            return i == 0 ? std::move(value) : get_matrix(arguments[2 * operands[i - 1]]);
+        };
+        return multiply_chain(chain_shapes.size(), order, load,
+                              [&](const Matrix &x, const Matrix &y) {
+                                  return mult(x, y, pool, options.algorithm, options.crossover);
+                              });
+    };
+
+    Matrix result_matrix = get_matrix(arguments[0]);
+    std::vector<std::size_t> run;
+
+    for (std::size_t i = 1; i < arguments.size(); i += 2) {
+        if (arguments[i] == MULT) {
+            run.push_back((i + 1) / 2);
+            continue;
+        }
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char ** argv) {
-    mse::check_input_format(argc, argv);
+        result_matrix = multiply_run(std::move(result_matrix), run);
+        run.clear();
+        result_matrix = add(result_matrix, get_matrix(arguments[i + 1]), pool);
+    }
+    result_matrix = multiply_run(std::move(result_matrix), run);
 
-    std::vector<std::vector<double>> result_matrix = mse::get_matrix(argv[1]);
+    std::cerr << std::fixed << std::setprecision(0)
+              << "Matrix chain flops: " << left_to_right << " left to right, "
+              << optimized << " optimized, " << left_to_right - optimized << " saved."
+              << std::endl;
+
+    return result_matrix;
+}
 
-    for (auto i = 2; i < argc; i += 2) {
-        const std::vector<std::vector<double>> current_matrix =
-            mse::get_matrix(argv[i + 1]);
+void print_result(const Matrix &result_matrix, bool full_precision) {
+    if (full_precision) {
+        std::cout << std::setprecision(std::numeric_limits<double>::max_digits10);
+    }
+    std::cout << result_matrix.rows() << " " << result_matrix.cols() << std::endl;
 
-        if (strcmp(argv[i], ADD) == 0) {
-            result_matrix = mse::add(result_matrix, current_matrix);
-        } else if (strcmp(argv[i], MULT) == 0) {
-            result_matrix = mse::mult(result_matrix, current_matrix);
+    for (std::size_t i = 0; i < result_matrix.rows(); ++i) {
+        for (const double element : result_matrix.row(i)) {
+            std::cout << element << " ";
         }
+        std::cout << std::endl;
     }
+}
+} // namespace mse
+
+
+int main(int argc, char **argv) {
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    const mse::Options options = mse::parse_options(arguments);
+    mse::check_input_format(arguments);
+
+    mse::ThreadPool pool(options.threads);
+    const mse::Matrix result_matrix = options.optimize_chain
+        ? mse::evaluate_optimized(arguments, pool, options)
+        : mse::evaluate(arguments, pool, options);
 
-    mse::print_result(result_matrix);
+    mse::print_result(result_matrix, options.full_precision);
     return 0;
 }
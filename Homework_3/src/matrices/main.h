@@ -1,33 +1,73 @@
 #pragma once
 
+#include "chain.h"
+#include "matrix.h"
+#include "strassen.h"
+#include "thread_pool.h"
+
 #include <numeric>
 #include <string>
 #include <vector>
 
 namespace mse {
 
-void check_input_format(const int &argc, char** &argv);
+// How mult multiplies: auto uses Strassen-Winograd for large products only,
+// classic never, strassen always at least at the top level.
+enum class MultAlgorithm { automatic, classic, strassen };
+
+// Options of the tool, which may be given anywhere among the matrices and
+// operations.
+struct Options {
+    // 0 means one per hardware thread.
+    unsigned threads = 0;
+    MultAlgorithm algorithm = MultAlgorithm::automatic;
+    // Size below which Strassen-Winograd hands products to the blocked kernel.
+    std::size_t crossover = default_strassen_crossover;
+    // Evaluate every run of --mult in the order with the fewest operations.
+    bool optimize_chain = false;
+    // Print the result with enough digits to read it back exactly.
+    bool full_precision = false;
+};
+
+// Removes the options from arguments and returns them. Throws
+// std::invalid_argument if an option is malformed.
+Options parse_options(std::vector<std::string> &arguments);
+
+void check_input_format(const std::vector<std::string> &arguments);
 
 std::fstream open_file(const std::string &file_name);
 
 void close_file(std::fstream &file);
 
-std::vector<std::vector<double>> read_matrix(std::fstream &file);
+Matrix read_matrix(std::fstream &file);
+
+Matrix get_matrix(const std::string &file_name);
+
+// The shape of the matrix in a file, read from its first line only.
+Shape get_shape(const std::string &file_name);
+
+void check_add_shapes(const Matrix &matrix_1, const Matrix &matrix_2);
 
-std::vector<std::vector<double>> get_matrix(const std::string &file_name);
+Matrix add(const Matrix &matrix_1, const Matrix &matrix_2, ThreadPool &pool);
 
-void check_add_shapes(const std::vector<std::vector<double>> &matrix_1,
-                      const std::vector<std::vector<double>> &matrix_2);
+void check_mult_shapes(const Matrix &matrix_1, const Matrix &matrix_2);
 
-std::vector<std::vector<double>> add(const std::vector<std::vector<double>> &matrix_1,
-                                     const std::vector<std::vector<double>> &matrix_2);
+Matrix mult(const Matrix &matrix_1, const Matrix &matrix_2, ThreadPool &pool,
+            MultAlgorithm algorithm, std::size_t crossover = default_strassen_crossover);
 
-void check_mult_shapes(const std::vector<std::vector<double>> &matrix_1,
-                       const std::vector<std::vector<double>> &matrix_2);
+// The value of the expression in arguments, evaluated left to right.
+Matrix evaluate(const std::vector<std::string> &arguments, ThreadPool &pool,
+                const Options &options);
 
-std::vector<std::vector<double>> mult(const std::vector<std::vector<double>> &matrix_1,
-                                      const std::vector<std::vector<double>> &matrix_2);
+// Same, but every run of --mult, which starts with the value so far, is
+// multiplied in the order with the fewest operations. The shapes of all the
+// matrices are checked before any of them is read. Reports the estimated
+// operations saved on stderr.
+Matrix evaluate_optimized(const std::vector<std::string> &arguments, ThreadPool &pool,
+                          const Options &options);
 
-void print_result(const std::vector<std::vector<double>> &result_matrix);
+// Prints the matrix in the input format. With full_precision every element
+// gets enough digits to be read back exactly, otherwise the stream default.
+void print_result(const Matrix &result_matrix, bool full_precision = false);
 
 } // namespace mse
@@ -0,0 +1,57 @@
+#include "matrix.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace mse {
+
+namespace {
+constexpr std::size_t doubles_per_line = Matrix::alignment / sizeof(double);
+
+double *allocate(std::size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+    return static_cast<double *>(::operator new[](
+        size * sizeof(double), std::align_val_t{Matrix::alignment}));
+}
+} // namespace
+
+void Matrix::AlignedDelete::operator()(double *data) const {
+    ::operator delete[](data, std::align_val_t{Matrix::alignment});
+}
+
+Matrix::Matrix(std::size_t rows, std::size_t cols)
+    : rows_(rows), cols_(cols),
+      stride_((cols + doubles_per_line - 1) / doubles_per_line * doubles_per_line),
+      data_(allocate(rows_ * stride_)) {
+    std::fill_n(data_.get(), rows_ * stride_, 0.0);
+}
+
+Matrix::Matrix(const Matrix &other)
+    : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_),
+      data_(allocate(rows_ * stride_)) {
+    std::copy_n(other.data_.get(), rows_ * stride_, data_.get());
+}
+
+Matrix::Matrix(Matrix &&other) noexcept
+    : rows_(std::exchange(other.rows_, 0)), cols_(std::exchange(other.cols_, 0)),
+      stride_(std::exchange(other.stride_, 0)), data_(std::move(other.data_)) {}
+
+Matrix &Matrix::operator=(const Matrix &other) {
+    if (this != &other) {
+        *this = Matrix(other);
+    }
+    return *this;
+}
+
+Matrix &Matrix::operator=(Matrix &&other) noexcept {
+    rows_ = std::exchange(other.rows_, 0);
+    cols_ = std::exchange(other.cols_, 0);
+    stride_ = std::exchange(other.stride_, 0);
+    data_ = std::move(other.data_);
+    return *this;
+}
+
+} // namespace mse
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace mse {
+
+// A non-owning view of a row-major block of a matrix: rows of cols elements,
+// consecutive rows stride elements apart.
+template <typename T>
+class BasicMatrixView {
+public:
+    BasicMatrixView() = default;
+
+    BasicMatrixView(T *data, std::size_t rows, std::size_t cols, std::size_t stride)
+        : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+    // A view of mutable elements is also a view of const ones.
+    template <typename U>
+        requires(!std::is_same_v<U, T> && std::is_convertible_v<U (*)[], T (*)[]>)
+    BasicMatrixView(BasicMatrixView<U> other)
+        : data_(other.data()), rows_(other.rows()), cols_(other.cols()),
+          stride_(other.stride()) {}
+
+    T *data() const { return data_; }
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t stride() const { return stride_; }
+
+    std::span<T> row(std::size_t i) const {
+        return {data_ + i * stride_, cols_};
+    }
+
+    T &operator()(std::size_t i, std::size_t j) const {
+        return data_[i * stride_ + j];
+    }
+
+    // The rows x cols block whose top-left element is (row, col). Throws
+    // std::out_of_range if it does not fit in this view.
+    BasicMatrixView submatrix(std::size_t row, std::size_t col,
+                              std::size_t rows, std::size_t cols) const {
+        if (row > rows_ || rows > rows_ - row || col > cols_ || cols > cols_ - col) {
+            throw std::out_of_range("Submatrix is out of the matrix bounds.");
+        }
+        return {data_ + row * stride_ + col, rows, cols, stride_};
+    }
+
+private:
+    T *data_ = nullptr;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t stride_ = 0;
+};
+
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicMatrixView<const double>;
+
+// A matrix of doubles in a single row-major buffer. Every row starts on an
+// alignment-byte boundary: rows are stride() elements apart, and the
+// elements past cols() in each row are zero.
+class Matrix {
+public:
+    static constexpr std::size_t alignment = 64;
+
+    Matrix() = default;
+
+    // A zero matrix.
+    Matrix(std::size_t rows, std::size_t cols);
+
+    Matrix(const Matrix &other);
+    Matrix(Matrix &&other) noexcept;
+    Matrix &operator=(const Matrix &other);
+    Matrix &operator=(Matrix &&other) noexcept;
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t stride() const { return stride_; }
+
+    double *data() { return data_.get(); }
+    const double *data() const { return data_.get(); }
+
+    double &operator()(std::size_t i, std::size_t j) {
+        return data_[i * stride_ + j];
+    }
+
+    double operator()(std::size_t i, std::size_t j) const {
+        return data_[i * stride_ + j];
+    }
+
+    std::span<double> row(std::size_t i) { return view().row(i); }
+    std::span<const double> row(std::size_t i) const { return view().row(i); }
+
+    MatrixView view() { return {data(), rows_, cols_, stride_}; }
+    ConstMatrixView view() const { return {data(), rows_, cols_, stride_}; }
+
+    MatrixView submatrix(std::size_t row, std::size_t col,
+                         std::size_t rows, std::size_t cols) {
+        return view().submatrix(row, col, rows, cols);
+    }
+
+    ConstMatrixView submatrix(std::size_t row, std::size_t col,
+                              std::size_t rows, std::size_t cols) const {
+        return view().submatrix(row, col, rows, cols);
+    }
+
+private:
+    struct AlignedDelete {
+        void operator()(double *data) const;
+    };
+
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t stride_ = 0;
+    std::unique_ptr<double[], AlignedDelete> data_;
+};
+
+} // namespace mse
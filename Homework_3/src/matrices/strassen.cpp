@@ -0,0 +1,118 @@
+#include "strassen.h"
+#include "elementwise.h"
+#include "gemm.h"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace mse {
+
+namespace {
+Matrix sum(ConstMatrixView x, ConstMatrixView y, ThreadPool &pool) {
+    Matrix out(x.rows(), x.cols());
+    elementwise(out.view(), x, y, std::plus<>(), pool);
+    return out;
+}
+
+Matrix difference(ConstMatrixView x, ConstMatrixView y, ThreadPool &pool) {
+    Matrix out(x.rows(), x.cols());
+    elementwise(out.view(), x, y, std::minus<>(), pool);
+    return out;
+}
+
+void multiply(ConstMatrixView a, ConstMatrixView b, MatrixView c, ThreadPool &pool,
+              std::size_t crossover, bool force) {
+    const std::size_t smallest = std::min({a.rows(), a.cols(), b.cols()});
+    if (smallest < 2 || (!force && smallest < crossover)) {
+        gemm(a, b, c, pool);
+        return;
+    }
+
+    const std::size_t m = a.rows() / 2;
+    const std::size_t k = a.cols() / 2;
+    const std::size_t n = b.cols() / 2;
+
+    const ConstMatrixView a11 = a.submatrix(0, 0, m, k);
+    const ConstMatrixView a12 = a.submatrix(0, k, m, k);
+    const ConstMatrixView a21 = a.submatrix(m, 0, m, k);
+    const ConstMatrixView a22 = a.submatrix(m, k, m, k);
+    const ConstMatrixView b11 = b.submatrix(0, 0, k, n);
+    const ConstMatrixView b12 = b.submatrix(0, n, k, n);
+    const ConstMatrixView b21 = b.submatrix(k, 0, k, n);
+    const ConstMatrixView b22 = b.submatrix(k, n, k, n);
+    const MatrixView c11 = c.submatrix(0, 0, m, n);
+    const MatrixView c12 = c.submatrix(0, n, m, n);
+    const MatrixView c21 = c.submatrix(m, 0, m, n);
+    const MatrixView c22 = c.submatrix(m, n, m, n);
+
+    // Winograd's form: with S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21,
+    // S4 = A12 - S2, T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12,
+    // T4 = T2 - B21 and P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4,
+    // P5 = S1 T1, P6 = S2 T2, P7 = S3 T3,
+    //   C11 = P1 + P2,            C12 = P1 + P6 + P5 + P3,
+    //   C21 = P1 + P6 + P7 - P4,  C22 = P1 + P6 + P7 + P5.
+    // Every product is added to c as soon as it is known, so that only one
+    // is held at a time.
+    auto add_product = [&](ConstMatrixView x, ConstMatrixView y,
+                           std::initializer_list<MatrixView> plus,
+                           std::initializer_list<MatrixView> minus) {
+        Matrix product(x.rows(), y.cols());
+        multiply(x, y, product.view(), pool, crossover, false);
+        for (const MatrixView quadrant : plus) {
+            elementwise(quadrant, quadrant, product.view(), std::plus<>(), pool);
+        }
+        for (const MatrixView quadrant : minus) {
+            elementwise(quadrant, quadrant, product.view(), std::minus<>(), pool);
+        }
+    };
+
+    add_product(a11, b11, {c11, c12, c21, c22}, {});
+    add_product(a12, b21, {c11}, {});
+    {
+        const Matrix s3 = difference(a11, a21, pool);
+        const Matrix t3 = difference(b22, b12, pool);
+        add_product(s3.view(), t3.view(), {c21, c22}, {});
+    }
+    {
+        const Matrix s1 = sum(a21, a22, pool);
+        const Matrix t1 = difference(b12, b11, pool);
+        add_product(s1.view(), t1.view(), {c12, c22}, {});
+
+        const Matrix s2 = difference(s1.view(), a11, pool);
+        const Matrix t2 = difference(b22, t1.view(), pool);
+        add_product(s2.view(), t2.view(), {c12, c21, c22}, {});
+
+        const Matrix s4 = difference(a12, s2.view(), pool);
+        add_product(s4.view(), b22, {c12}, {});
+
+        const Matrix t4 = difference(t2.view(), b21, pool);
+        add_product(a22, t4.view(), {}, {c21});
+    }
+
+    // What the even-sized blocks miss: the last inner index, and the last
+    // column and row of c.
+    if (a.cols() % 2 == 1) {
+        gemm(a.submatrix(0, 2 * k, 2 * m, 1), b.submatrix(2 * k, 0, 1, 2 * n),
+             c.submatrix(0, 0, 2 * m, 2 * n), pool);
+    }
+    if (b.cols() % 2 == 1) {
+        gemm(a, b.submatrix(0, 2 * n, b.rows(), 1), c.submatrix(0, 2 * n, c.rows(), 1), pool);
+    }
+    if (a.rows() % 2 == 1) {
+        gemm(a.submatrix(2 * m, 0, 1, a.cols()), b.submatrix(0, 0, b.rows(), 2 * n),
+             c.submatrix(2 * m, 0, 1, 2 * n), pool);
+    }
+}
+} // namespace
+
+void strassen(ConstMatrixView a, ConstMatrixView b, MatrixView c, ThreadPool &pool,
+              std::size_t crossover, bool force) {
+    if (a.cols() != b.rows() || a.rows() != c.rows() || b.cols() != c.cols()) {
+        throw std::invalid_argument("Matrix sizes do not match each other.");
+    }
+    multiply(a, b, c, pool, crossover, force);
+}
+
+} // namespace mse
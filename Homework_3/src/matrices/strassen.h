@@ -0,0 +1,22 @@
+#pragma once
+
+#include "matrix.h"
+#include "thread_pool.h"
+
+#include <cstddef>
+
+namespace mse {
+
+// From this size on, in every dimension, a product is split by Strassen-Winograd
+// rather than handed whole to gemm.
+inline constexpr std::size_t default_strassen_crossover = 2048;
+
+// c += a * b by Strassen-Winograd recursion: 7 products of half-size blocks
+// instead of 8, until a dimension falls below crossover and gemm takes over.
+// Odd dimensions are peeled off: the last row, column or inner index is
+// handled by gemm on the side. force splits the first level whatever the
+// sizes. Throws std::invalid_argument if the shapes do not match.
+void strassen(ConstMatrixView a, ConstMatrixView b, MatrixView c, ThreadPool &pool,
+              std::size_t crossover = default_strassen_crossover, bool force = false);
+
+} // namespace mse
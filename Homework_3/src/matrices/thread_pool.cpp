@@ -0,0 +1,94 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace mse {
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threads - 1);
+    for (unsigned k = 1; k < threads; k++) {
+        workers_.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    loop_started_.notify_all();
+
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t count,
+                              const std::function<void(std::size_t)> &task) {
+    if (count == 0) {
+        return;
+    }
+
+    {
+        const std::lock_guard lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_index_ = 0;
+        error_ = nullptr;
+        busy_workers_ = workers_.size();
+        loop_++;
+    }
+    loop_started_.notify_all();
+
+    run_tasks();
+
+    std::unique_lock lock(mutex_);
+    loop_finished_.wait(lock, [this] { return busy_workers_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void ThreadPool::run_tasks() {
+    for (std::size_t i = next_index_++; i < count_; i = next_index_++) {
+        try {
+            (*task_)(i);
+        } catch (...) {
+            const std::lock_guard lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            next_index_ = count_;
+        }
+    }
+}
+
+void ThreadPool::work() {
+    std::size_t loop = 0;
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            loop_started_.wait(lock, [&] { return stopping_ || loop_ != loop; });
+            if (stopping_) {
+                return;
+            }
+            loop = loop_;
+        }
+
+        run_tasks();
+
+        const std::lock_guard lock(mutex_);
+        if (--busy_workers_ == 0) {
+            loop_finished_.notify_one();
+        }
+    }
+}
+
+} // namespace mse
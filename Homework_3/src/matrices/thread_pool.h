@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mse {
+
+// A fixed set of threads that run parallel loops. The thread that calls
+// parallel_for takes part in the loop, so a pool of one thread starts no
+// threads and runs every loop inline.
+class ThreadPool {
+public:
+    // 0 threads means one per hardware thread.
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // The number of threads, the calling one included.
+    std::size_t size() const { return workers_.size() + 1; }
+
+    // Runs task(0), ..., task(count - 1) and returns when all of them are
+    // done. Every thread takes the next index not taken yet, so threads that
+    // draw cheap tasks take more of them. If a task throws, the remaining
+    // indices are skipped and the first exception is rethrown. Must not be
+    // called from a task.
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)> &task);
+
+private:
+    void run_tasks();
+    void work();
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable loop_started_;
+    std::condition_variable loop_finished_;
+    std::size_t loop_ = 0;
+    std::size_t busy_workers_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    const std::function<void(std::size_t)> *task_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_index_ = 0;
+};
+
+} // namespace mse
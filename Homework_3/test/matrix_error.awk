@@ -0,0 +1,51 @@
+#!/usr/bin/awk -f
+
+# Usage:
+#     matrix_error.awk reference_matrix.txt other_matrix.txt
+#
+# Prints the largest absolute and relative differences between the elements
+# of two matrices of the same size.
+
+BEGIN {
+  # Set record separator to read all file as single line
+  RS="";
+  mat1_len=0;
+  mat2_len=0;
+}
+
+{
+  for (i = 1; i <= NF; i++)
+  {
+    if (!($i ~ "^[ \r\n]*$"))
+    {
+      if (NR == FNR)
+        mat1[mat1_len++] = $i;
+      else
+        mat2[mat2_len++] = $i;
+    }
+  }
+}
+
+END {
+  if (mat1_len != mat2_len || mat1[0] != mat2[0] || mat1[1] != mat2[1])
+  {
+    print "Matrices sizes don't match";
+    exit 1;
+  }
+
+  max_abs = 0;
+  max_rel = 0;
+  for (i = 2; i < mat1_len; i++)
+  {
+    diff = mat1[i] - mat2[i];
+    if (diff < 0)
+      diff = -diff;
+    ref = mat1[i] < 0 ? -mat1[i] : mat1[i];
+    rel = diff / (ref == 0 ? 1 : ref);
+    if (diff > max_abs)
+      max_abs = diff;
+    if (rel > max_rel)
+      max_rel = rel;
+  }
+  print "Max absolute error: " max_abs ", max relative error: " max_rel;
+}
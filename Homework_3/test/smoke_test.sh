@@ -1,5 +1,8 @@
 #!/bin/sh -eu
 
+# The options of the shebang are lost when the script is run as "bash smoke_test.sh".
+set -eu
+
 if [ "$#" -lt 1 ]; then
     echo "Usage:"
     echo "    $0 path_to_matrices"
@@ -10,6 +13,13 @@ EXECUTABLE="$1"
 REAL_EXEC="$EXECUTABLE"
 SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
 
+# Outputs and generated matrices go to a scratch directory, removed on exit,
+# so that the test leaves nothing behind in the source tree.
+SCRATCH=$(mktemp -d)
+trap 'rm -rf "$SCRATCH"' EXIT
+OUT="$SCRATCH/out.txt"
+ERR="$SCRATCH/err.txt"
+
 VALGRIND_OPTS="--leak-check=yes -q --leak-resolution=high --main-stacksize=64000000"
 # To use Valgrind uncomment next line:
 #REAL_EXEC="valgrind $VALGRIND_OPTS $EXECUTABLE"
@@ -17,31 +27,31 @@ VALGRIND_OPTS="--leak-check=yes -q --leak-resolution=high --main-stacksize=64000
 run()
 {
     echo "***** Running: $EXECUTABLE $@"
-    $REAL_EXEC "$@" 1>out.txt 2>err.txt
+    $REAL_EXEC "$@" 1>"$OUT" 2>"$ERR"
     CODE=$?
-    cat out.txt
-    cat err.txt
+    cat "$OUT"
+    cat "$ERR"
     return $CODE
 }
 
 compare()
 {
-    $SCRIPT_DIR/compare_matrices.awk $SCRIPT_DIR/$1 $2
+    awk -f "$SCRIPT_DIR/compare_matrices.awk" "$SCRIPT_DIR/$1" "$2"
 }
 
 check_empty_err()
 {
-    test ! -s err.txt || (echo "Error: expected empty stderr, got:"; cat err.txt; exit 1)
+    test ! -s "$ERR" || (echo "Error: expected empty stderr, got:"; cat "$ERR"; exit 1)
 }
 
 check_empty_out()
 {
-    test ! -s out.txt || (echo "Error: expected empty stdout, got:"; cat out.txt; exit 1)
+    test ! -s "$OUT" || (echo "Error: expected empty stdout, got:"; cat "$OUT"; exit 1)
 }
 
 check_non_empty_err()
 {
-    test -s err.txt || (echo "Error: expected non-empty stderr"; exit 1)
+    test -s "$ERR" || (echo "Error: expected non-empty stderr"; exit 1)
 }
 
 expected_error()
@@ -54,9 +64,9 @@ expected_ok()
 {
     echo "Error: expected zero exit code"
     echo "stdout:"
-    cat out.txt
+    cat "$OUT"
     echo "stderr:"
-    cat err.txt
+    cat "$ERR"
     exit 1
 }
 
@@ -67,50 +77,132 @@ h()
 
 # "run" wraps run of actual matrices executable
 run 5.txt || expected_ok
-compare 5.txt out.txt
+compare 5.txt "$OUT"
 check_empty_err
 
 run 5.txt --add 2.txt || expected_ok
-compare 7.txt out.txt
+compare 7.txt "$OUT"
 check_empty_err
 
 run 5.txt --mult 2.txt || expected_ok
-compare 10.txt out.txt
+compare 10.txt "$OUT"
 check_empty_err
 
 run q_7x7.txt --mult r_7x16.txt || expected_ok
-compare 7x16_0-111.txt out.txt
+compare 7x16_0-111.txt "$OUT"
 check_empty_err
 
 run rr_16x7.txt --mult qq_7x7.txt || expected_ok
-compare 16x7_0-111.txt out.txt
+compare 16x7_0-111.txt "$OUT"
 check_empty_err
 
 run 0-167_8x21.txt --add 0-334_8x21.txt || expected_ok
-compare 8x21_-167-0.txt out.txt
+compare 8x21_-167-0.txt "$OUT"
 check_empty_err
 
 run 0-167_21x8.txt --add 0-334_21x8.txt || expected_ok
-compare 21x8_-167-0.txt out.txt
+compare 21x8_-167-0.txt "$OUT"
 check_empty_err
 
 run 5.txt --mult 2.txt --add 4.txt || expected_ok
-compare 14.txt out.txt
+compare 14.txt "$OUT"
 check_empty_err
 
 run 1.txt --mult 2.txt --add 0.txt --mult 3.txt || expected_ok
-compare 6.txt out.txt
+compare 6.txt "$OUT"
 check_empty_err
 
 run A_3x7.txt --mult B_7x13.txt --add minus_A_mult_B.txt || expected_ok
-compare 3x13_0.txt out.txt
+compare 3x13_0.txt "$OUT"
 check_empty_err
 
 # filename without txt extension: "5"
 run 5 || expected_ok
-compare 5.txt out.txt
+compare 5.txt "$OUT"
+check_empty_err
+
+# Number of threads, before, between or after the operations
+run 5.txt --mult 2.txt --threads 3 || expected_ok
+compare 10.txt "$OUT"
+check_empty_err
+
+run --threads=2 1.txt --mult 2.txt --add 0.txt --mult 3.txt || expected_ok
+compare 6.txt "$OUT"
+check_empty_err
+
+run A_3x7.txt --threads 1 --mult B_7x13.txt --add minus_A_mult_B.txt || expected_ok
+compare 3x13_0.txt "$OUT"
+check_empty_err
+
+# Strassen-Winograd, forced even for small and odd-sized matrices
+run --algo=strassen 5.txt --mult 2.txt || expected_ok
+compare 10.txt "$OUT"
+check_empty_err
+
+run q_7x7.txt --mult r_7x16.txt --algo strassen || expected_ok
+compare 7x16_0-111.txt "$OUT"
+check_empty_err
+
+run rr_16x7.txt --algo=strassen --mult qq_7x7.txt || expected_ok
+compare 16x7_0-111.txt "$OUT"
 check_empty_err
 
+run A_3x7.txt --mult B_7x13.txt --add minus_A_mult_B.txt --algo=strassen || expected_ok
+compare 3x13_0.txt "$OUT"
+check_empty_err
+
+# Strassen-Winograd against the classical product on random matrices
+random_matrix()
+{
+    awk -v rows="$1" -v cols="$2" -v seed="$3" 'BEGIN {
+        srand(seed);
+        print rows, cols;
+        for (i = 0; i < rows; i++) {
+            line = "";
+            for (j = 0; j < cols; j++)
+                line = line sprintf("%.6f ", rand() * 20 - 10);
+            print line;
+        }
+    }'
+}
+
+random_matrix 129 101 1 > "$SCRATCH/strassen_a.txt"
+random_matrix 101 77 2 > "$SCRATCH/strassen_b.txt"
+# By default results keep the stream's 6 significant digits.
+run --algo=classic "$SCRATCH/strassen_a.txt" --mult "$SCRATCH/strassen_b.txt" >/dev/null \
+    || expected_ok
+awk 'NR > 1 { for (i = 1; i <= NF; i++) { sub(/e.*/, "", $i); gsub(/[^0-9]/, "", $i);
+                                          sub(/^0+/, "", $i); if (length($i) > 6) exit 1 } }' \
+    "$OUT" || (echo "Error: expected at most 6 significant digits"; exit 1)
+
+# Results are printed with all significant digits, so the error is exact.
+run --algo=classic --full-precision "$SCRATCH/strassen_a.txt" --mult "$SCRATCH/strassen_b.txt" \
+    >/dev/null || expected_ok
+mv "$OUT" "$SCRATCH/strassen_classic.txt"
+for crossover in 2048 32 8; do
+    run --algo=strassen --crossover=$crossover --full-precision "$SCRATCH/strassen_a.txt" \
+        --mult "$SCRATCH/strassen_b.txt" >/dev/null || expected_ok
+    check_empty_err
+    awk -f "$SCRIPT_DIR/compare_matrices.awk" "$SCRATCH/strassen_classic.txt" "$OUT"
+    awk -f "$SCRIPT_DIR/matrix_error.awk" "$SCRATCH/strassen_classic.txt" "$OUT"
+done
+
+# Chains of --mult reordered by the matrix-chain dynamic program; the flops
+# saved are reported on stderr
+run 1.txt --mult 2.txt --add 0.txt --mult 3.txt --optimize-chain || expected_ok
+compare 6.txt "$OUT"
+check_non_empty_err
+
+run --optimize-chain 5.txt --mult 2.txt --add 4.txt || expected_ok
+compare 14.txt "$OUT"
+check_non_empty_err
+
+run rr_16x7.txt --mult q_7x7.txt --mult r_7x16.txt --threads 1 >/dev/null || expected_ok
+mv "$OUT" "$SCRATCH/chain_plain.txt"
+run rr_16x7.txt --mult q_7x7.txt --mult r_7x16.txt --threads 1 --optimize-chain >/dev/null || expected_ok
+check_non_empty_err
+awk -f "$SCRIPT_DIR/compare_matrices.awk" "$SCRATCH/chain_plain.txt" "$OUT"
+
 # No arguments - should be an error
 run && expected_error
 check_empty_out
@@ -180,9 +272,54 @@ run B_7x13.txt --mult 7.txt && expected_error
 check_empty_out
 check_non_empty_err
 
+run A_3x7.txt --mult B_7x13.txt --mult A_3x7.txt --optimize-chain && expected_error
+check_empty_out
+check_non_empty_err
+
+run A_3x7.txt --mult B_7x13.txt --add A_3x7.txt --mult B_7x13.txt --optimize-chain && expected_error
+check_empty_out
+check_non_empty_err
+
 # Missing matrix file - should be an error
 run 2.txt --add xxx.txt && expected_error
 check_empty_out
 check_non_empty_err
 
+# Unknown or missing algorithm - should be an error
+run 5.txt --mult 2.txt --algo=fast && expected_error
+check_empty_out
+check_non_empty_err
+
+run 5.txt --mult 2.txt --algo && expected_error
+check_empty_out
+check_non_empty_err
+
+# Incorrect or missing crossover size - should be an error
+run 5.txt --mult 2.txt --crossover=0 && expected_error
+check_empty_out
+check_non_empty_err
+
+run 5.txt --mult 2.txt --crossover && expected_error
+check_empty_out
+check_non_empty_err
+
+# Incorrect number of threads - should be an error
+run 5.txt --threads 0 && expected_error
+check_empty_out
+check_non_empty_err
+
+run 5.txt --threads=x && expected_error
+check_empty_out
+check_non_empty_err
+
+# Far more threads than hardware threads - should be an error
+run 5.txt --threads 999999 && expected_error
+check_empty_out
+check_non_empty_err
+
+# Missing number of threads - should be an error
+run 5.txt --threads && expected_error
+check_empty_out
+check_non_empty_err
+
 echo "Smoke test passed!"